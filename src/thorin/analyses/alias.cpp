@@ -0,0 +1,175 @@
+#include "thorin/analyses/alias.h"
+
+#include <algorithm>
+
+#include "thorin/primop.h"
+
+namespace thorin {
+
+MemLoc::MemLoc(const Def* ptr)
+    : ptr_(ptr)
+{
+    // alignment hints do not change the address
+    auto strip = [] (const Def* def) {
+        while (auto aligned = def->isa<Aligned>())
+            def = aligned->ptr();
+        return def;
+    };
+
+    auto cur = strip(ptr);
+    while (auto lea = cur->isa<LEA>()) {
+        path_.push_back(lea->index());
+        cur = strip(lea->ptr());
+    }
+    std::reverse(path_.begin(), path_.end());
+    base_ = cur;
+
+    // look through pointer casts to find the underlying object
+    object_ = base_;
+    while (auto conv = object_->isa<ConvOp>()) {
+        if (!conv->from()->type()->isa<PtrType>())
+            break;
+        is_casted_ = true;
+        object_ = strip(conv->from());
+        while (auto lea = object_->isa<LEA>())
+            object_ = strip(lea->ptr());
+    }
+}
+
+bool is_identified_object(const Def* def) {
+    return def->isa<Slot>() || def->isa<Global>() || Alloc::is_out_ptr(def);
+}
+
+bool any_ptr_use(const Def* object, std::function<bool(Use)> pred) {
+    std::vector<const Def*> stack;
+    DefSet done;
+    stack.push_back(object);
+    done.insert(object);
+
+    while (!stack.empty()) {
+        auto def = stack.back();
+        stack.pop_back();
+
+        for (auto use : def->uses()) {
+            if ((use->isa<LEA>() && use.index() == 0) || use->isa<Aligned>() || (use->isa<ConvOp>() && use->type()->isa<PtrType>())) {
+                if (done.emplace(use.def()).second)
+                    stack.push_back(use.def());
+            } else if (pred(use)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool is_escaping(const Def* object) {
+    if (!object->isa<Slot>() && !Alloc::is_out_ptr(object))
+        return true;
+
+    return any_ptr_use(object, [] (Use use) {
+        return !((use->isa<Load>() || use->isa<Store>() || use->isa<Prefetch>()) && use.index() == 1);
+    });
+}
+
+static bool is_compatible(const Type* t1, const Type* t2) {
+    auto p1 = t1->isa<PrimType>();
+    auto p2 = t2->isa<PrimType>();
+    if (p1 == nullptr || p2 == nullptr)
+        return true;
+
+    // precise/quick as well as signed/unsigned variants of the same size share their representation
+    auto tag1 = p1->primtype_tag(), tag2 = p2->primtype_tag();
+    return num_bits(tag1) == num_bits(tag2)
+        && is_type_f(tag1) == is_type_f(tag2)
+        && is_type_bool(t1) == is_type_bool(t2);
+}
+
+AliasResult alias(const MemLoc& loc1, const MemLoc& loc2) {
+    if (loc1.ptr() == loc2.ptr())
+        return AliasResult::Must;
+
+    auto ptr_type1 = loc1.ptr()->type()->as<PtrType>();
+    auto ptr_type2 = loc2.ptr()->type()->as<PtrType>();
+    if (ptr_type1->addr_space() != ptr_type2->addr_space()
+            && ptr_type1->addr_space() != AddrSpace::Generic
+            && ptr_type2->addr_space() != AddrSpace::Generic)
+        return AliasResult::No;
+
+    if (loc1.base() == loc2.base()) {
+        const auto& path1 = loc1.path();
+        const auto& path2 = loc2.path();
+        for (size_t i = 0, e = std::min(path1.size(), path2.size()); i != e; ++i) {
+            if (path1[i] == path2[i])
+                continue;
+            if (path1[i]->isa<PrimLit>() && path2[i]->isa<PrimLit>()) {
+                if (primlit_value<u64>(path1[i]) != primlit_value<u64>(path2[i]))
+                    return AliasResult::No;
+                continue;
+            }
+            return AliasResult::May;
+        }
+
+        // one path may be a prefix of the other which means that one location contains the other one
+        if (path1.size() == path2.size() && ptr_type1 == ptr_type2)
+            return AliasResult::Must;
+        return AliasResult::May;
+    }
+
+    auto object1 = loc1.object();
+    auto object2 = loc2.object();
+    if (object1 != object2) {
+        bool is_identified1 = is_identified_object(object1);
+        bool is_identified2 = is_identified_object(object2);
+        if (is_identified1 && is_identified2)
+            return AliasResult::No;
+        // the address of a non-escaping object cannot be obtained in any other way
+        if ((is_identified1 && !is_escaping(object1)) || (is_identified2 && !is_escaping(object2)))
+            return AliasResult::No;
+    }
+
+    if (!loc1.is_casted() && !loc2.is_casted() && !is_compatible(ptr_type1->pointee(), ptr_type2->pointee()))
+        return AliasResult::No;
+
+    return AliasResult::May;
+}
+
+const Def* find_value(const Def* mem, const Def* ptr, const Def** stop, size_t max_steps) {
+    MemLoc loc(ptr);
+    auto type = ptr->type()->as<PtrType>()->pointee();
+
+    auto stop_at = [&] (const Def* mem) -> const Def* {
+        if (stop)
+            *stop = mem;
+        return nullptr;
+    };
+
+    for (size_t i = 0; i != max_steps; ++i) {
+        auto cur = mem;
+        if (auto extract = mem->isa<Extract>())
+            mem = extract->agg();
+
+        if (auto store = mem->isa<Store>()) {
+            switch (alias(MemLoc(store->ptr()), loc)) {
+                case AliasResult::Must:
+                    if (store->val()->type() == type)
+                        return store->val();
+                    return stop_at(cur);
+                case AliasResult::May: return stop_at(cur);
+                case AliasResult::No:  mem = store->mem(); break;
+            }
+        } else if (auto load = mem->isa<Load>()) {
+            if (load->out_val_type() == type && alias(MemLoc(load->ptr()), loc) == AliasResult::Must)
+                return load->out_val();
+            mem = load->mem();
+        } else if (mem->isa<Enter>() || mem->isa<Alloc>() || mem->isa<Prefetch>()) {
+            mem = mem->as<MemOp>()->mem();
+        } else {
+            return stop_at(cur);
+        }
+    }
+
+    return stop_at(mem);
+}
+
+}
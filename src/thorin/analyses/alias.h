@@ -0,0 +1,68 @@
+#ifndef THORIN_ANALYSES_ALIAS_H
+#define THORIN_ANALYSES_ALIAS_H
+
+#include <functional>
+#include <vector>
+
+#include "thorin/def.h"
+
+namespace thorin {
+
+enum class AliasResult {
+    No,     ///< The two pointers never refer to overlapping memory.
+    May,    ///< Nothing is known.
+    Must,   ///< The two pointers always refer to the very same memory.
+};
+
+/**
+ * A pointer decomposed into the @p base it is derived from via a @p path of @p LEA indices.
+ * @p object is the underlying allocation which is found by additionally looking through pointer casts.
+ * @p Aligned hints are skipped everywhere.
+ */
+class MemLoc {
+public:
+    explicit MemLoc(const Def* ptr);
+
+    const Def* ptr() const { return ptr_; }
+    const Def* base() const { return base_; }
+    const Def* object() const { return object_; }
+    const std::vector<const Def*>& path() const { return path_; }
+    bool is_casted() const { return is_casted_; }
+
+private:
+    const Def* ptr_;
+    const Def* base_;
+    const Def* object_;
+    std::vector<const Def*> path_; ///< @p LEA indices from @p base_ to @p ptr_.
+    bool is_casted_ = false;
+};
+
+/// Is @p def a @p Slot, a @p Global or the pointer of an @p Alloc?
+bool is_identified_object(const Def* def);
+/**
+ * Does @p pred hold for any @p Use of @p object or of a pointer derived from it?
+ * Pointers are derived via @p LEA%s, @p Aligned hints and pointer casts - the uses deriving them are not passed to @p pred.
+ */
+bool any_ptr_use(const Def* object, std::function<bool(Use)> pred);
+/// Is the address of the @p Slot or @p Alloc @p object used for anything else than loading from, storing to or prefetching it?
+bool is_escaping(const Def* object);
+
+/**
+ * Compares two pointers by their base objects and offsets.
+ * Furthermore, distinct address spaces never alias and - like C's strict aliasing rule -
+ * neither do pointers to distinct primitive types unless one of them has been obtained via a cast.
+ */
+AliasResult alias(const MemLoc&, const MemLoc&);
+inline AliasResult alias(const Def* ptr1, const Def* ptr2) { return alias(MemLoc(ptr1), MemLoc(ptr2)); }
+
+/**
+ * Memory dependence query:
+ * Walks the mem chain upwards starting at @p mem and returns the value known to reside at @p ptr.
+ * Returns @c nullptr if the walk hits a possibly clobbering @p MemOp, the beginning of the chain or @p max_steps.
+ * In this case @p stop - if given - receives the mem where the walk stopped.
+ */
+const Def* find_value(const Def* mem, const Def* ptr, const Def** stop = nullptr, size_t max_steps = 64);
+
+}
+
+#endif
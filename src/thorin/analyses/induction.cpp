@@ -0,0 +1,281 @@
+#include "thorin/analyses/induction.h"
+
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/scope.h"
+
+namespace thorin {
+
+typedef LoopTree<true>::Head LoopHead;
+typedef LoopTree<true>::Leaf LoopLeaf;
+typedef LoopTree<true>::Node LoopNode;
+
+static void collect(const LoopNode* node, ContinuationSet& body) {
+    if (auto leaf = node->isa<LoopLeaf>())
+        body.insert(leaf->cf_node()->continuation());
+    else {
+        for (const auto& child : node->as<LoopHead>()->children())
+            collect(child.get(), body);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+const InductionVar* InductionLoop::induction_var(const Param* param) const {
+    for (const auto& var : induction_vars_) {
+        if (var.param == param)
+            return &var;
+    }
+    return nullptr;
+}
+
+void InductionLoop::analyze() {
+    for (auto param : head()->params()) {
+        auto type = param->type()->isa<PrimType>();
+        if (type == nullptr || !is_type_i(type->primtype_tag()))
+            continue;
+
+        auto next = latch()->arg(param->index())->isa<ArithOp>();
+        if (next == nullptr || (next->arithop_tag() != ArithOp_add && next->arithop_tag() != ArithOp_sub))
+            continue;
+
+        const Def* other;
+        if (next->lhs() == param)
+            other = next->rhs();
+        else if (next->rhs() == param && next->arithop_tag() == ArithOp_add)
+            other = next->lhs();
+        else
+            continue;
+
+        if (!other->isa<PrimLit>())
+            continue;
+        s64 step = primlit_value<s64>(other);
+        if (step == 0)
+            continue;
+        if (next->arithop_tag() == ArithOp_sub)
+            step = -step;
+
+        induction_vars_.push_back({param, entry()->arg(param->index()), step});
+    }
+
+    stay_ = contains(head()->arg(1)->as_continuation()) ? 1 : 2;
+
+    auto cond = head()->arg(0);
+    if (auto expect = cond->isa<Expect>())
+        cond = expect->value();
+
+    if (auto cmp = cond->isa<Cmp>()) {
+        auto tag = stay_ == 1 ? cmp->cmp_tag() : negate(cmp->cmp_tag());
+        auto var = induction_var(cmp->lhs()->isa<Param>());
+        auto bound = cmp->rhs();
+        if (var == nullptr) {
+            var = induction_var(cmp->rhs()->isa<Param>());
+            bound = cmp->lhs();
+            tag = commute(tag);
+        }
+
+        if (var != nullptr && is_invariant(bound)) {
+            exit_var_ = var;
+            cmp_tag_ = tag;
+            bound_ = bound;
+            compute_trip_count();
+        }
+    }
+}
+
+bool InductionLoop::is_invariant(const Def* def) const {
+    std::vector<const Def*> stack(1, def);
+    DefSet done;
+    done.insert(def);
+
+    while (!stack.empty()) {
+        auto def = stack.back();
+        stack.pop_back();
+
+        if (auto param = def->isa<Param>()) {
+            if (contains(param->continuation()))
+                return false;
+        } else if (auto primop = def->isa<PrimOp>()) {
+            for (auto op : primop->ops()) {
+                if (done.insert(op).second)
+                    stack.push_back(op);
+            }
+        }
+    }
+
+    return true;
+}
+
+void InductionLoop::compute_trip_count() {
+    if (!exit_var()->start->isa<PrimLit>() || !bound()->isa<PrimLit>())
+        return;
+
+    auto tag = exit_var()->param->type()->as<PrimType>()->primtype_tag();
+    auto bits = num_bits(tag);
+    bool is_signed = is_type_s(tag);
+
+    // keep away from the limits of s64 so the computations below don't overflow
+    const s64 limit = s64(1) << 62;
+    auto get = [&] (const Def* def, s64& val) {
+        if (is_signed)
+            val = primlit_value<s64>(def);
+        else {
+            auto u = primlit_value<u64>(def);
+            if (u >= u64(limit))
+                return false;
+            val = s64(u);
+        }
+        return -limit < val && val < limit;
+    };
+
+    s64 start, bound, step = exit_var()->step;
+    if (!get(exit_var()->start, start) || !get(this->bound(), bound) || step <= -limit || step >= limit)
+        return;
+
+    s64 n;
+    switch (cmp_tag()) {
+        case Cmp_lt:
+            if (step < 0) return;
+            n = start < bound ? (bound - start + step - 1) / step : 0;
+            break;
+        case Cmp_le:
+            if (step < 0) return;
+            n = start <= bound ? (bound - start) / step + 1 : 0;
+            break;
+        case Cmp_gt:
+            if (step > 0) return;
+            n = start > bound ? (start - bound - step - 1) / -step : 0;
+            break;
+        case Cmp_ge:
+            if (step > 0) return;
+            n = start >= bound ? (start - bound) / -step + 1 : 0;
+            break;
+        case Cmp_ne:
+            if ((bound - start) % step != 0 || (bound - start) / step < 0) return;
+            n = (bound - start) / step;
+            break;
+        default:
+            return;
+    }
+
+    // the exit var must not wrap around before the loop is left
+    if (n > limit / (step < 0 ? -step : step))
+        return;
+    s64 last = start + n * step;
+    if (bits < 64) {
+        s64 min = is_signed ? -(s64(1) << (bits - 1)) : 0;
+        s64 max = is_signed ?  (s64(1) << (bits - 1)) - 1 : (s64(1) << bits) - 1;
+        if (last < min || last > max)
+            return;
+    } else if (!is_signed && last < 0) {
+        return;
+    }
+
+    trip_count_ = n;
+}
+
+const Def* InductionLoop::symbolic_trip_count() const {
+    if (exit_var() == nullptr)
+        return nullptr;
+
+    auto& world = head()->world();
+    auto type = exit_var()->param->type();
+    if (has_constant_trip_count())
+        return world.cast(type, world.literal_qs64(trip_count(), {}));
+
+    auto start = exit_var()->start;
+    auto step = exit_var()->step;
+    auto zero = world.zero(type);
+    auto lit = [&] (s64 val) { return world.cast(type, world.literal_qs64(val, {})); };
+    auto div = [&] (const Def* a, s64 b) { return b == 1 ? a : world.arithop(ArithOp_div, a, lit(b)); };
+
+    switch (cmp_tag()) {
+        case Cmp_lt:
+            if (step < 0) return nullptr;
+            return world.select(world.cmp(Cmp_lt, start, bound()),
+                                div(world.arithop(ArithOp_add, world.arithop(ArithOp_sub, bound(), start), lit(step - 1)), step), zero);
+        case Cmp_le:
+            if (step < 0) return nullptr;
+            return world.select(world.cmp(Cmp_le, start, bound()),
+                                world.arithop(ArithOp_add, div(world.arithop(ArithOp_sub, bound(), start), step), lit(1)), zero);
+        case Cmp_gt:
+            if (step > 0) return nullptr;
+            return world.select(world.cmp(Cmp_gt, start, bound()),
+                                div(world.arithop(ArithOp_add, world.arithop(ArithOp_sub, start, bound()), lit(-step - 1)), -step), zero);
+        case Cmp_ge:
+            if (step > 0) return nullptr;
+            return world.select(world.cmp(Cmp_ge, start, bound()),
+                                world.arithop(ArithOp_add, div(world.arithop(ArithOp_sub, start, bound()), -step), lit(1)), zero);
+        case Cmp_ne:
+            // otherwise, the exit var may jump over the bound
+            if (step == 1)  return world.arithop(ArithOp_sub, bound(), start);
+            if (step == -1) return world.arithop(ArithOp_sub, start, bound());
+            return nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+Induction::Induction(const LoopTree<true>& looptree)
+    : looptree_(looptree)
+{
+    create(looptree.root());
+}
+
+const InductionLoop* Induction::operator[](Continuation* head) const {
+    for (const auto& loop : loops_) {
+        if (loop->head() == head)
+            return loop.get();
+    }
+    return nullptr;
+}
+
+void Induction::create(const LoopHead* node) {
+    for (const auto& child : node->children()) {
+        if (auto head = child->isa<LoopHead>())
+            create(head);
+    }
+
+    if (node->is_root() || node->num_cf_nodes() != 1)
+        return;
+
+    auto head = node->cf_nodes().front()->continuation();
+    if (head == scope().entry() || !head->is_basicblock() || head->callee() != scope().world().branch())
+        return;
+
+    auto loop = std::make_unique<InductionLoop>(node, head, nullptr, nullptr);
+    collect(node, loop->body_);
+
+    for (auto pred : cfg().preds(head)) {
+        auto continuation = pred->continuation();
+        if (continuation->callee() != head)
+            return;
+        auto& p = loop->contains(continuation) ? loop->latch_ : loop->entry_;
+        if (p != nullptr)
+            return;
+        p = continuation;
+    }
+    if (loop->entry() == nullptr || loop->latch() == nullptr)
+        return;
+
+    bool t = loop->contains(head->arg(1)->as_continuation());
+    bool f = loop->contains(head->arg(2)->as_continuation());
+    if (t == f)
+        return;
+
+    for (auto continuation : loop->body()) {
+        if (continuation == head)
+            continue;
+        for (auto succ : cfg().succs(continuation)) {
+            if (!loop->contains(succ->continuation()))
+                loop->single_exit_ = false;
+        }
+    }
+
+    loop->analyze();
+    loops_.emplace_back(std::move(loop));
+}
+
+}
@@ -0,0 +1,118 @@
+#ifndef THORIN_ANALYSES_INDUCTION_H
+#define THORIN_ANALYSES_INDUCTION_H
+
+#include <memory>
+#include <vector>
+
+#include "thorin/continuation.h"
+#include "thorin/enums.h"
+#include "thorin/analyses/looptree.h"
+
+namespace thorin {
+
+class PrimLit;
+
+/**
+ * A @p Param of a loop header which receives @p start on entry and is advanced by @p step in each iteration.
+ * In the latch, the arg for @p param is either <tt>add param, lit</tt> or <tt>sub param, lit</tt>;
+ * the latter is normalized to a negative @p step.
+ */
+struct InductionVar {
+    const Param* param;
+    const Def* start;
+    s64 step;
+};
+
+/**
+ * A loop with a single header @p head which is entered from @p entry and continued from @p latch only.
+ * All of its continuations form the @p body.
+ */
+class InductionLoop {
+public:
+    InductionLoop(const LoopTree<true>::Head* node, Continuation* head, Continuation* entry, Continuation* latch)
+        : node_(node)
+        , head_(head)
+        , entry_(entry)
+        , latch_(latch)
+    {}
+
+    const LoopTree<true>::Head* node() const { return node_; }
+    Continuation* head() const { return head_; }
+    Continuation* entry() const { return entry_; }
+    Continuation* latch() const { return latch_; }
+    const ContinuationSet& body() const { return body_; }
+    bool contains(Continuation* continuation) const { return body_.contains(continuation); }
+    /// Does the loop only exit via the @p Branch of its @p head?
+    bool is_single_exit() const { return single_exit_; }
+    ArrayRef<InductionVar> induction_vars() const { return induction_vars_; }
+    const InductionVar* induction_var(const Param*) const;
+    /// Does @p def not depend on any @p Param of the @p body?
+    bool is_invariant(const Def* def) const;
+
+    /**
+     * The loop runs while <tt>exit_var() cmp_tag() bound()</tt> holds.
+     * @p exit_var is @c nullptr if the exit test of @p head is not such a comparison.
+     */
+    const InductionVar* exit_var() const { return exit_var_; }
+    CmpTag cmp_tag() const { return cmp_tag_; }
+    const Def* bound() const { return bound_; }
+    /// Index of the target of @p head's @p Branch which stays within the loop - @c 1 or @c 2.
+    size_t stay() const { return stay_; }
+
+    /// The number of times the body runs if @p exit_var starts and ends at literals - @c u64(-1) otherwise.
+    u64 trip_count() const { return trip_count_; }
+    bool has_constant_trip_count() const { return trip_count_ != u64(-1); }
+    /**
+     * Builds the number of iterations as an expression in the @p World.
+     * This assumes that @p exit_var does not wrap around and yields @c nullptr if no such expression is known.
+     */
+    const Def* symbolic_trip_count() const;
+
+private:
+    void analyze();
+    void compute_trip_count();
+
+    const LoopTree<true>::Head* node_;
+    Continuation* head_;
+    Continuation* entry_;
+    Continuation* latch_;
+    ContinuationSet body_;
+    bool single_exit_ = true;
+    std::vector<InductionVar> induction_vars_;
+    const InductionVar* exit_var_ = nullptr;
+    CmpTag cmp_tag_;
+    const Def* bound_ = nullptr;
+    size_t stay_ = 0;
+    u64 trip_count_ = u64(-1);
+
+    friend class Induction;
+};
+
+/**
+ * Recognizes the @p InductionLoop%s of a @p LoopTree and classifies the params of their headers.
+ * Loops that are not of this shape - e.g. those with several entries or back edges - are not listed.
+ */
+class Induction {
+public:
+    Induction(const Induction&) = delete;
+    Induction& operator=(Induction) = delete;
+
+    explicit Induction(const LoopTree<true>& looptree);
+
+    const LoopTree<true>& looptree() const { return looptree_; }
+    const CFG<true>& cfg() const { return looptree_.cfg(); }
+    const Scope& scope() const { return cfg().scope(); }
+    /// All @p InductionLoop%s - inner loops come before outer ones.
+    ArrayRef<std::unique_ptr<InductionLoop>> loops() const { return loops_; }
+    const InductionLoop* operator[](Continuation* head) const;
+
+private:
+    void create(const LoopTree<true>::Head* node);
+
+    const LoopTree<true>& looptree_;
+    std::vector<std::unique_ptr<InductionLoop>> loops_;
+};
+
+}
+
+#endif
@@ -0,0 +1,405 @@
+#include "thorin/analyses/range.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "thorin/world.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/domtree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+
+namespace thorin {
+
+static const s64 s64_min = std::numeric_limits<s64>::min();
+static const s64 s64_max = std::numeric_limits<s64>::max();
+
+/*
+ * checked arithmetic on s64 - returns false on overflow
+ */
+
+static bool add(s64 a, s64 b, s64& r) {
+    if ((b > 0 && a > s64_max - b) || (b < 0 && a < s64_min - b))
+        return false;
+    r = a + b;
+    return true;
+}
+
+static bool sub(s64 a, s64 b, s64& r) {
+    if ((b < 0 && a > s64_max + b) || (b > 0 && a < s64_min + b))
+        return false;
+    r = a - b;
+    return true;
+}
+
+static bool mul(s64 a, s64 b, s64& r) {
+    if (a != 0 && b != 0) {
+        if (a > 0 ? (b > 0 ? a > s64_max / b : b < s64_min / a)
+                  : (b > 0 ? a < s64_min / b : b < s64_max / a))
+            return false;
+    }
+    r = a * b;
+    return true;
+}
+
+/*
+ * Interval
+ */
+
+static Interval signed_range(int bits) {
+    if (bits == 64)
+        return Interval(s64_min, s64_max);
+    return Interval(-(s64(1) << (bits - 1)), (s64(1) << (bits - 1)) - 1);
+}
+
+/// As the upper bound of a @c u64 cannot be represented, this is only a subset for 64 bits.
+static Interval unsigned_range(int bits) {
+    if (bits == 64)
+        return Interval(0, s64_max);
+    return Interval(0, (s64(1) << bits) - 1);
+}
+
+Interval Interval::of(PrimTypeTag tag) {
+    assert(is_type_i(tag));
+    auto bits = num_bits(tag);
+    if (is_type_s(tag))
+        return signed_range(bits);
+    return bits == 64 ? Interval() : unsigned_range(bits);
+}
+
+Interval Interval::join(Interval other) const {
+    if (!is_known() || !other.is_known())
+        return Interval();
+    return Interval(std::min(lo(), other.lo()), std::max(hi(), other.hi()));
+}
+
+Interval Interval::meet(Interval other) const {
+    if (!is_known())
+        return other;
+    if (!other.is_known())
+        return *this;
+    auto l = std::max(lo(), other.lo());
+    auto h = std::min(hi(), other.hi());
+    // an empty range means that this code is unreachable - just keep what we have
+    return l <= h ? Interval(l, h) : *this;
+}
+
+static Interval add(Interval a, Interval b) {
+    s64 lo, hi;
+    if (a.is_known() && b.is_known() && add(a.lo(), b.lo(), lo) && add(a.hi(), b.hi(), hi))
+        return Interval(lo, hi);
+    return Interval();
+}
+
+static Interval sub(Interval a, Interval b) {
+    s64 lo, hi;
+    if (a.is_known() && b.is_known() && sub(a.lo(), b.hi(), lo) && sub(a.hi(), b.lo(), hi))
+        return Interval(lo, hi);
+    return Interval();
+}
+
+static Interval mul(Interval a, Interval b) {
+    if (!a.is_known() || !b.is_known())
+        return Interval();
+
+    s64 c[4];
+    if (!mul(a.lo(), b.lo(), c[0]) || !mul(a.lo(), b.hi(), c[1]) || !mul(a.hi(), b.lo(), c[2]) || !mul(a.hi(), b.hi(), c[3]))
+        return Interval();
+    return Interval(*std::min_element(c, c + 4), *std::max_element(c, c + 4));
+}
+
+/// @p a shifted left by @p b - as multiplication with a power of two.
+static Interval shl(Interval a, Interval b, int bits) {
+    if (!b.is_known() || b.lo() < 0 || b.hi() >= std::min(bits, 63))
+        return Interval();
+    return mul(a, Interval(s64(1) << b.lo(), s64(1) << b.hi()));
+}
+
+static Interval apply(ArithOpTag tag, Interval a, Interval b, int bits) {
+    switch (tag) {
+        case ArithOp_add: return add(a, b);
+        case ArithOp_sub: return sub(a, b);
+        case ArithOp_mul: return mul(a, b);
+        case ArithOp_shl: return shl(a, b, bits);
+        default: THORIN_UNREACHABLE;
+    }
+}
+
+/// Refines @p r by the knowledge that <tt>r tag b</tt> holds.
+static Interval refine(Interval r, CmpTag tag, Interval b) {
+    if (!r.is_known() || !b.is_known())
+        return r;
+
+    switch (tag) {
+        case Cmp_eq: return r.meet(b);
+        case Cmp_lt: return b.hi() == s64_min ? r : r.meet(Interval(s64_min, b.hi() - 1));
+        case Cmp_le: return r.meet(Interval(s64_min, b.hi()));
+        case Cmp_gt: return b.lo() == s64_max ? r : r.meet(Interval(b.lo() + 1, s64_max));
+        case Cmp_ge: return r.meet(Interval(b.lo(), s64_max));
+        default:     return r;
+    }
+}
+
+/// The number of trailing zero bits @p def has at least.
+static int trailing_zeros(const Def* def, int depth = 0) {
+    if (auto lit = def->isa<PrimLit>()) {
+        auto val = primlit_value<u64>(lit);
+        int n = 0;
+        for (; n != 64 && (val & (u64(1) << n)) == 0; ++n) {}
+        return n;
+    }
+
+    // low bits are not affected by wrap-around, so the flags don't matter here
+    if (auto arithop = def->isa<ArithOp>()) {
+        if (depth == 8)
+            return 0;
+        auto a = trailing_zeros(arithop->lhs(), depth + 1);
+        switch (arithop->arithop_tag()) {
+            case ArithOp_add:
+            case ArithOp_sub:
+            case ArithOp_or:  return std::min(a, trailing_zeros(arithop->rhs(), depth + 1));
+            case ArithOp_and: return std::max(a, trailing_zeros(arithop->rhs(), depth + 1));
+            case ArithOp_mul: return std::min(a + trailing_zeros(arithop->rhs(), depth + 1), 64);
+            case ArithOp_shl:
+                if (arithop->rhs()->isa<PrimLit>())
+                    return std::min(a + int(primlit_value<u64>(arithop->rhs()) & 63), 64);
+                return a;
+            default: return 0;
+        }
+    }
+
+    return 0;
+}
+
+/// Yields the @p PrimTypeTag of @p def if it is a scalar integer.
+static bool is_int(const Def* def, PrimTypeTag& tag) {
+    if (auto type = def->type()->isa<PrimType>()) {
+        tag = type->primtype_tag();
+        return type->length() == 1 && is_type_i(tag);
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+RangeAnalysis::RangeAnalysis(const Scope& scope)
+    : scope_(scope)
+    , induction_(scope.f_cfg().looptree())
+{
+    run();
+}
+
+Interval RangeAnalysis::operator[](const Def* def) const {
+    PrimTypeTag tag;
+    if (!is_int(def, tag))
+        return Interval();
+
+    if (auto lit = def->isa<PrimLit>()) {
+        if (is_type_s(tag)) {
+            auto val = primlit_value<s64>(lit);
+            return Interval(val, val);
+        }
+        auto val = primlit_value<u64>(lit);
+        return val <= u64(s64_max) ? Interval(val, val) : Interval();
+    }
+
+    auto i = ranges_.find(def);
+    if (i != ranges_.end())
+        return i->second;
+    return Interval::of(tag);
+}
+
+Interval RangeAnalysis::range(const Def* def, Continuation* continuation) const {
+    auto r = (*this)[def];
+    if (!r.is_known() || def->isa<PrimLit>())
+        return r;
+
+    // look for compares on the edges into the dominators of continuation
+    const auto& cfg = scope().f_cfg();
+    const auto& domtree = cfg.domtree();
+    for (auto n = cfg[continuation]; n != cfg.entry(); n = domtree.idom(n)) {
+        if (cfg.num_preds(n) != 1)
+            continue;
+        auto pred = (*cfg.preds(n).begin())->continuation();
+        if (pred->callee() != scope().world().branch())
+            continue;
+
+        auto cond = pred->arg(0);
+        if (auto expect = cond->isa<Expect>())
+            cond = expect->value();
+        if (auto cmp = cond->isa<Cmp>()) {
+            auto tag = pred->arg(1) == n->continuation() ? cmp->cmp_tag() : negate(cmp->cmp_tag());
+            if (cmp->lhs() == def)
+                r = refine(r, tag, (*this)[cmp->rhs()]);
+            else if (cmp->rhs() == def)
+                r = refine(r, commute(tag), (*this)[cmp->lhs()]);
+        }
+    }
+
+    return r;
+}
+
+ArithOp::Flags RangeAnalysis::flags(const ArithOp* arithop) const {
+    auto i = flags_.find(arithop);
+    return i != flags_.end() ? i->second : ArithOp::NoFlag;
+}
+
+Interval RangeAnalysis::induction_range(const InductionVar& var, const InductionLoop& loop) const {
+    if (&var != loop.exit_var())
+        return Interval();
+
+    auto start = (*this)[var.start];
+    auto bound = (*this)[loop.bound()];
+    if (!start.is_known() || !bound.is_known())
+        return Interval();
+
+    // the exit var moves monotonically from start towards bound and overshoots by less than step
+    s64 step = var.step, lo = start.lo(), hi = start.hi(), last;
+    switch (loop.cmp_tag()) {
+        case Cmp_lt:
+            if (step < 0 || !add(bound.hi(), step - 1, last)) return Interval();
+            hi = std::max(hi, last);
+            break;
+        case Cmp_le:
+            if (step < 0 || !add(bound.hi(), step, last)) return Interval();
+            hi = std::max(hi, last);
+            break;
+        case Cmp_gt:
+            if (step > 0 || !add(bound.lo(), step + 1, last)) return Interval();
+            lo = std::min(lo, last);
+            break;
+        case Cmp_ge:
+            if (step > 0 || !add(bound.lo(), step, last)) return Interval();
+            lo = std::min(lo, last);
+            break;
+        default:
+            return Interval();
+    }
+
+    // otherwise, the exit var may wrap around before the loop is left
+    auto tag = var.param->type()->as<PrimType>()->primtype_tag();
+    auto bits = num_bits(tag);
+    Interval r(lo, hi);
+    return r.is_within(is_type_s(tag) ? signed_range(bits) : unsigned_range(bits)) ? r : Interval();
+}
+
+void RangeAnalysis::run() {
+    Schedule schedule(scope());
+
+    for (const auto& block : schedule.blocks()) {
+        auto continuation = block.continuation();
+        if (auto loop = induction_[continuation]) {
+            for (const auto& var : loop->induction_vars()) {
+                auto r = induction_range(var, *loop);
+                if (r.is_known())
+                    ranges_[var.param] = r;
+            }
+        }
+
+        for (auto primop : block) {
+            PrimTypeTag tag;
+            if (!is_int(primop, tag) || primop->isa<PrimLit>())
+                continue;
+            auto r = transfer(primop, continuation, tag);
+            if (r.is_known())
+                ranges_[primop] = r;
+        }
+    }
+}
+
+Interval RangeAnalysis::transfer(const PrimOp* primop, Continuation* continuation, PrimTypeTag tag) {
+    auto type_range = Interval::of(tag);
+    auto bits = num_bits(tag);
+    Interval r;
+
+    if (auto arithop = primop->isa<ArithOp>()) {
+        auto a = range(arithop->lhs(), continuation);
+        auto b = range(arithop->rhs(), continuation);
+        auto flags = ArithOp::NoFlag;
+
+        switch (arithop->arithop_tag()) {
+            case ArithOp_add:
+            case ArithOp_sub:
+            case ArithOp_mul:
+            case ArithOp_shl: {
+                r = apply(arithop->arithop_tag(), a, b, bits);
+
+                // reinterpret the operands with the other signedness if their values allow for it
+                bool is_signed = is_type_s(tag);
+                auto as_signed   = [&] (Interval x) { return  is_signed || x.is_within(signed_range(bits))   ? x : Interval(); };
+                auto as_unsigned = [&] (Interval x) { return !is_signed || x.is_within(unsigned_range(bits)) ? x : Interval(); };
+                if (apply(arithop->arithop_tag(), as_signed(a), as_signed(b), bits).is_within(signed_range(bits)))
+                    flags |= ArithOp::NSW;
+                if (apply(arithop->arithop_tag(), as_unsigned(a), as_unsigned(b), bits).is_within(unsigned_range(bits)))
+                    flags |= ArithOp::NUW;
+                break;
+            }
+            case ArithOp_div:
+                if (b.is_known() && b.lo() > 0 && a.is_known()) {
+                    s64 c[4] = { a.lo() / b.lo(), a.lo() / b.hi(), a.hi() / b.lo(), a.hi() / b.hi() };
+                    r = Interval(*std::min_element(c, c + 4), *std::max_element(c, c + 4));
+                }
+                if (auto lit = arithop->rhs()->isa<PrimLit>()) {
+                    auto d = primlit_value<u64>(lit);
+                    if (b.is_known() && b.lo() > 0 && (d & (d - 1)) == 0 && trailing_zeros(arithop->lhs()) >= trailing_zeros(lit))
+                        flags |= ArithOp::Exact;
+                }
+                break;
+            case ArithOp_rem:
+                if (b.is_known() && b.lo() > 0 && a.is_known()) {
+                    auto m = b.hi() - 1;
+                    if (a.lo() >= 0)
+                        r = Interval(0, std::min(a.hi(), m));
+                    else if (a.hi() <= 0)
+                        r = Interval(std::max(a.lo(), -m), 0);
+                    else
+                        r = Interval(-m, m);
+                }
+                break;
+            case ArithOp_and:
+                if (a.is_known() && a.lo() >= 0 && b.is_known() && b.lo() >= 0)
+                    r = Interval(0, std::min(a.hi(), b.hi()));
+                else if (a.is_known() && a.lo() >= 0)
+                    r = Interval(0, a.hi());
+                else if (b.is_known() && b.lo() >= 0)
+                    r = Interval(0, b.hi());
+                break;
+            case ArithOp_or:
+            case ArithOp_xor:
+                if (a.is_known() && a.lo() >= 0 && b.is_known() && b.lo() >= 0 && std::max(a.hi(), b.hi()) < (s64(1) << 62)) {
+                    s64 p = 1;
+                    while (p <= std::max(a.hi(), b.hi()))
+                        p <<= 1;
+                    r = Interval(0, p - 1);
+                }
+                break;
+            case ArithOp_shr:
+                if (a.is_known() && b.is_known() && b.lo() >= 0 && b.hi() < std::min(bits, 63)) {
+                    s64 c[4] = { a.lo() >> b.lo(), a.lo() >> b.hi(), a.hi() >> b.lo(), a.hi() >> b.hi() };
+                    r = Interval(*std::min_element(c, c + 4), *std::max_element(c, c + 4));
+                }
+                if (arithop->rhs()->isa<PrimLit>() && b.is_known() && b.lo() >= 0 && trailing_zeros(arithop->lhs()) >= b.lo())
+                    flags |= ArithOp::Exact;
+                break;
+        }
+
+        if (flags != ArithOp::NoFlag)
+            flags_[arithop] = flags;
+    } else if (auto cast = primop->isa<Cast>()) {
+        PrimTypeTag from;
+        if (is_int(cast->from(), from))
+            r = range(cast->from(), continuation);
+        else if (is_type_bool(cast->from()->type()))
+            r = Interval(0, 1);
+    } else if (auto select = primop->isa<Select>()) {
+        r = range(select->tval(), continuation).join(range(select->fval(), continuation));
+    } else if (auto expect = primop->isa<Expect>()) {
+        r = range(expect->value(), continuation);
+    }
+
+    // the value wraps around otherwise
+    auto valid = is_type_s(tag) ? signed_range(bits) : unsigned_range(bits);
+    return r.is_within(valid) ? r : type_range;
+}
+
+}
@@ -0,0 +1,77 @@
+#ifndef THORIN_ANALYSES_RANGE_H
+#define THORIN_ANALYSES_RANGE_H
+
+#include "thorin/primop.h"
+#include "thorin/analyses/induction.h"
+
+namespace thorin {
+
+class Scope;
+
+/**
+ * The closed interval <tt>[lo, hi]</tt> of the mathematical values an integer @p Def may take.
+ * Values of signed types are interpreted as signed and those of unsigned types as unsigned.
+ * A @p Interval is unknown if it cannot be represented with @p s64 bounds - e.g. the one of an arbitrary @c u64.
+ */
+class Interval {
+public:
+    Interval() {}
+    Interval(s64 lo, s64 hi)
+        : lo_(lo)
+        , hi_(hi)
+        , known_(true)
+    {
+        assert(lo <= hi);
+    }
+
+    /// All values of the integer type @p tag.
+    static Interval of(PrimTypeTag tag);
+
+    bool is_known() const { return known_; }
+    s64 lo() const { assert(known_); return lo_; }
+    s64 hi() const { assert(known_); return hi_; }
+    bool is_within(Interval other) const { return known_ && other.known_ && other.lo_ <= lo_ && hi_ <= other.hi_; }
+    Interval join(Interval other) const;
+    Interval meet(Interval other) const;
+
+private:
+    s64 lo_ = 0;
+    s64 hi_ = 0;
+    bool known_ = false;
+};
+
+/**
+ * Value range analysis for the integer @p Def%s of a @p Scope.
+ * Ranges originate from literals, the types themselves and @p InductionVar%s which are bounded by the exit test of their loop.
+ * They are propagated through arithmetic and casts and refined by the compares of the @p Branch%es dominating a use.
+ */
+class RangeAnalysis {
+public:
+    RangeAnalysis(const RangeAnalysis&) = delete;
+    RangeAnalysis& operator=(RangeAnalysis) = delete;
+
+    explicit RangeAnalysis(const Scope& scope);
+
+    const Scope& scope() const { return scope_; }
+    const Induction& induction() const { return induction_; }
+    /// The @p Interval of @p def anywhere in the @p scope.
+    Interval operator[](const Def* def) const;
+    /// The @p Interval of @p def within @p continuation.
+    Interval range(const Def* def, Continuation* continuation) const;
+    /// The @p ArithOp::Flags that hold for @p arithop according to the @p Interval%s of its operands.
+    ArithOp::Flags flags(const ArithOp* arithop) const;
+
+private:
+    void run();
+    Interval transfer(const PrimOp*, Continuation*, PrimTypeTag);
+    Interval induction_range(const InductionVar& var, const InductionLoop& loop) const;
+
+    const Scope& scope_;
+    Induction induction_;
+    DefMap<Interval> ranges_;
+    DefMap<ArithOp::Flags> flags_;
+};
+
+}
+
+#endif
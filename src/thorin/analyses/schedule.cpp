@@ -184,6 +184,8 @@ void Scheduler::topo_sort(Def2CFNode& def2node) {
         DefSet done;
 
         auto inside = [&](const Def* def) {
+            if (!def->isa<PrimOp>()) // Params are part of def2early_ but don't need to be sorted
+                return false;
             auto i = def2node.find(def);
             return i != def2node.end() && i->second == block.node();
         };
@@ -234,9 +236,46 @@ Schedule::Schedule(const Scope& scope, Tag tag)
 }
 
 void Schedule::block_schedule() {
-    // until we have sth better simply use the RPO of the CFG
+    const auto& profile = world().profile();
+    std::vector<const CFNode*> rpo;
+    if (profile.empty()) {
+        // until we have sth better simply use the RPO of the CFG
+        rpo.assign(cfg().reverse_post_order().begin(), cfg().reverse_post_order().end());
+    } else {
+        // a DFS which visits the hottest successor last places it right after its predecessor in the resulting RPO
+        std::vector<const CFNode*> post_order;
+        std::vector<std::pair<const CFNode*, std::vector<const CFNode*>>> stack;
+        F_CFG::Set visited(cfg());
+
+        auto push = [&] (const CFNode* n) {
+            visited.insert(n);
+            std::vector<const CFNode*> succs(cfg().succs(n).begin(), cfg().succs(n).end());
+            // descending hotness as succs are popped from the back
+            std::stable_sort(succs.begin(), succs.end(), [&] (const CFNode* n1, const CFNode* n2) {
+                return profile.hotness(n1->continuation()) > profile.hotness(n2->continuation());
+            });
+            stack.emplace_back(n, std::move(succs));
+        };
+
+        push(cfg().entry());
+        while (!stack.empty()) {
+            auto& succs = stack.back().second;
+            if (succs.empty()) {
+                post_order.push_back(stack.back().first);
+                stack.pop_back();
+            } else {
+                auto succ = succs.back();
+                succs.pop_back();
+                if (!visited.contains(succ))
+                    push(succ);
+            }
+        }
+
+        rpo.assign(post_order.rbegin(), post_order.rend());
+    }
+
     size_t i = 0;
-    for (auto n : cfg().reverse_post_order()) {
+    for (auto n : rpo) {
         auto& block = blocks_[i];
         block.node_ = n;
         block.index_ = i;
@@ -51,6 +51,7 @@ private:
     const std::string var_name(const Def*);
     const std::string get_lang() const;
     bool is_texture_type(const Type*);
+    bool is_streamable(const Type*);
 
     World& world_;
     const Cont2Config& kernel_config_;
@@ -62,6 +63,7 @@ private:
     DefMap<std::string> primop2str_;
     bool use_64_ = false;
     bool use_16_ = false;
+    bool use_region_ = false;
     bool debug_;
     int primop_counter = 0;
     std::ostream& os_;
@@ -501,7 +503,7 @@ void CCodeGen::emit() {
                 }
 
                 // skip higher-order primops, stuff dealing with frames and all memory related stuff except stores
-                if (primop->type()->isa<FnType>() || primop->type()->isa<FrameType>() || ((is_mem(primop) || is_unit(primop)) && !primop->isa<Store>()))
+                if (primop->type()->isa<FnType>() || primop->type()->isa<FrameType>() || ((is_mem(primop) || is_unit(primop)) && !primop->isa<Store>() && !primop->isa<Prefetch>()))
                     continue;
 
                 emit_debug_info(primop);
@@ -618,6 +620,19 @@ void CCodeGen::emit() {
                                 func_impl_ << endl
                                            << "#pragma HLS dependence variable=" << name << " inter false" << endl
                                            << "#pragma HLS data_pack  variable=" << name;
+                        } else if (callee->intrinsic() == Intrinsic::EnterRegion) {
+                            if (lang_ != Lang::C99)
+                                ELOG(&continuation->jump_debug(), "enter_region: only allowed in host code");
+                            auto cont = continuation->arg(1)->as_continuation();
+                            func_impl_ << "p" << cont->param(1)->unique_name() << " = (";
+                            emit_type(func_impl_, cont->param(1)->type()) << ")anydsl_region_enter(0);";
+                            use_region_ = true;
+                        } else if (callee->intrinsic() == Intrinsic::LeaveRegion) {
+                            func_impl_ << "anydsl_region_leave(";
+                            emit(continuation->arg(1)) << ");";
+                            use_region_ = true;
+                        } else if (callee->intrinsic() == Intrinsic::Tile) {
+                            // a mere hint for loop_tiling
                         } else {
                             THORIN_UNREACHABLE;
                         }
@@ -708,6 +723,19 @@ void CCodeGen::emit() {
     if (lang_==Lang::CUDA && use_16_)
         os_ << "#include <cuda_fp16.h>" << endl << endl;
 
+    // CUDA contracts by default; everything else of the module's fast-math flags is up to the options of the compiler
+    if (world().fast_math() & ArithOp::Contract) {
+        if (lang_==Lang::OPENCL)
+            os_ << "#pragma OPENCL FP_CONTRACT ON" << endl << endl;
+        else if (lang_==Lang::C99 || lang_==Lang::HLS)
+            os_ << "#pragma STDC FP_CONTRACT ON" << endl << endl;
+    }
+
+    if (use_region_)
+        os_ << "void* anydsl_region_enter(int);" << endl
+            << "void* anydsl_region_alloc(void*, unsigned long);" << endl
+            << "void anydsl_region_leave(void*);" << endl << endl;
+
     if (lang_==Lang::CUDA || lang_==Lang::HLS)
         os_ << "extern \"C\" {" << endl;
 
@@ -782,6 +810,20 @@ std::ostream& CCodeGen::emit(const Def* def) {
         emit_aggop_defs(bin->rhs());
         emit_type(func_impl_, bin->type()) << " " << def_name << ";" << endl;
         func_impl_ << def_name << " = ";
+
+        // the GPU dialects have a fast division which may use the reciprocal of its divisor
+        if (auto arithop = bin->isa<ArithOp>()) {
+            auto tag = arithop->type()->primtype_tag();
+            if ((lang_ == Lang::CUDA || lang_ == Lang::OPENCL) && arithop->arithop_tag() == ArithOp_div && arithop->is_arcp()
+                    && (tag == PrimType_pf32 || tag == PrimType_qf32) && arithop->type()->length() == 1) {
+                func_impl_ << (lang_ == Lang::CUDA ? "__fdividef(" : "native_divide(");
+                emit(bin->lhs()) << ", ";
+                emit(bin->rhs()) << ");";
+                insert(def, def_name);
+                return func_impl_;
+            }
+        }
+
         emit(bin->lhs());
         if (auto cmp = bin->isa<Cmp>()) {
             switch (cmp->cmp_tag()) {
@@ -1026,18 +1068,44 @@ std::ostream& CCodeGen::emit(const Def* def) {
         emit_type(func_impl_, load->out_val()->type()) << " " << def_name << ";" << endl;
         func_impl_ << def_name << " = ";
         // handle texture fetches
-        if (!is_texture_type(load->ptr()->type()))
+        if (is_texture_type(load->ptr()->type())) {
+            emit(load->ptr()) << ";";
+        } else if (load->is_nontemporal() && is_streamable(load->out_val_type())) {
+            func_impl_ << "__ldcs(";
+            emit(load->ptr()) << ");";
+        } else {
             func_impl_ << "*";
-        emit(load->ptr()) << ";";
+            emit(load->ptr()) << ";";
+        }
 
         insert(def, def_name);
         return func_impl_;
     }
 
     if (auto store = def->isa<Store>()) {
-        emit_aggop_defs(store->val()) << "*";
-        emit(store->ptr()) << " = ";
-        emit(store->val()) << ";";
+        if (store->is_nontemporal() && is_streamable(store->val()->type())) {
+            emit_aggop_defs(store->val()) << "__stcs(";
+            emit(store->ptr()) << ", ";
+            emit(store->val()) << ");";
+        } else {
+            emit_aggop_defs(store->val()) << "*";
+            emit(store->ptr()) << " = ";
+            emit(store->val()) << ";";
+        }
+
+        insert(def, def_name);
+        return func_impl_;
+    }
+
+    if (auto prefetch = def->isa<Prefetch>()) {
+        auto ptr_type = prefetch->ptr()->type()->as<PtrType>();
+        if (lang_ == Lang::C99) {
+            func_impl_ << "__builtin_prefetch(";
+            emit(prefetch->ptr()) << ", " << prefetch->is_write() << ", " << prefetch->locality() << ");";
+        } else if (lang_ == Lang::OPENCL && ptr_type->addr_space() == AddrSpace::Global) {
+            func_impl_ << "prefetch(";
+            emit(prefetch->ptr()) << ", 1);";
+        }
 
         insert(def, def_name);
         return func_impl_;
@@ -1054,6 +1122,27 @@ std::ostream& CCodeGen::emit(const Def* def) {
     if (def->isa<Enter>())
         return func_impl_;
 
+    if (auto alloc = def->isa<Alloc>()) {
+        if (alloc->region() == nullptr || lang_ != Lang::C99)
+            ELOG(def, "alloc: only allocations in a region are supported by the C backend");
+        emit_type(func_impl_, alloc->out_ptr_type()) << " " << def_name << ";" << endl;
+        func_impl_ << def_name << " = (";
+        emit_type(func_impl_, alloc->out_ptr_type()) << ")anydsl_region_alloc(";
+        emit(alloc->region()) << ", ";
+        if (auto array = alloc->alloced_type()->isa<IndefiniteArrayType>()) {
+            func_impl_ << "sizeof(";
+            emit_type(func_impl_, array->elem_type()) << ") * ";
+            emit(alloc->extra());
+        } else {
+            func_impl_ << "sizeof(";
+            emit_type(func_impl_, alloc->alloced_type()) << ")";
+        }
+        func_impl_ << ");";
+        use_region_ = true;
+        insert(def, def_name);
+        return func_impl_;
+    }
+
     if (def->isa<Vector>()) {
         THORIN_UNREACHABLE;
     }
@@ -1210,6 +1299,39 @@ std::ostream& CCodeGen::emit(const Def* def) {
         return func_impl_;
     }
 
+    if (auto expect = def->isa<Expect>()) {
+        emit_aggop_defs(expect->value());
+        emit_type(func_impl_, expect->type()) << " " << def_name << ";" << endl;
+        func_impl_ << def_name << " = ";
+        // OpenCL C lacks __builtin_expect
+        if (lang_ == Lang::OPENCL) {
+            emit(expect->value()) << ";";
+        } else {
+            func_impl_ << "__builtin_expect(";
+            emit(expect->value()) << ", ";
+            emit(expect->expected()) << ");";
+        }
+        insert(def, def_name);
+        return func_impl_;
+    }
+
+    if (auto aligned = def->isa<Aligned>()) {
+        emit_aggop_defs(aligned->ptr());
+        emit_addr_space(func_impl_, aligned->type());
+        emit_type(func_impl_, aligned->type()) << " " << def_name << ";" << endl;
+        func_impl_ << def_name << " = ";
+        // OpenCL C lacks __builtin_assume_aligned
+        if (lang_ == Lang::C99 || lang_ == Lang::CUDA) {
+            func_impl_ << "(";
+            emit_type(func_impl_, aligned->type()) << ")__builtin_assume_aligned(";
+            emit(aligned->ptr()) << ", " << aligned->align() << ");";
+        } else {
+            emit(aligned->ptr()) << ";";
+        }
+        insert(def, def_name);
+        return func_impl_;
+    }
+
     THORIN_UNREACHABLE;
 }
 
@@ -1278,6 +1400,15 @@ bool CCodeGen::is_texture_type(const Type* type) {
     return false;
 }
 
+/// Can the CUDA cache-streaming intrinsics @c __ldcs and @c __stcs access a value of type @p type?
+bool CCodeGen::is_streamable(const Type* type) {
+    if (auto prim = type->isa<PrimType>()) {
+        auto tag = prim->primtype_tag();
+        return lang_ == Lang::CUDA && (is_type_i(tag) || is_type_f(tag)) && tag != PrimType_pf16 && tag != PrimType_qf16;
+    }
+    return false;
+}
+
 //------------------------------------------------------------------------------
 
 void emit_c(World& world, const Cont2Config& kernel_config, std::ostream& stream, Lang lang, bool debug) { CCodeGen(world, kernel_config, stream, lang, debug).emit(); }
@@ -15,6 +15,7 @@ protected:
     virtual void emit_function_decl_hook(Continuation*, llvm::Function*) override;
     virtual unsigned convert_addr_space(const AddrSpace) override;
     virtual llvm::Value* emit_global(const Global*) override;
+    virtual llvm::Value* emit_prefetch(const Prefetch*) override { return nullptr; } // not supported by AMDGPU
     virtual Continuation* emit_reserve(const Continuation*) override;
     virtual std::string get_alloc_name() const override { return "malloc"; }
     virtual std::string get_output_name(const std::string& name) const override { return name + ".amdgpu"; }
@@ -11,6 +11,7 @@ public:
 
 protected:
     virtual std::string get_alloc_name() const override { return "anydsl_alloc"; }
+    virtual unsigned get_alloc_alignment() const override { return 32; } // the runtime aligns host memory for AVX
     virtual std::string get_output_name(const std::string& name) const override { return name + ".ll"; }
 };
 
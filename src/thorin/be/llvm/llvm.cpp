@@ -1,6 +1,7 @@
 #include "thorin/be/llvm/llvm.h"
 
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 #include <llvm/ADT/Triple.h>
@@ -12,6 +13,7 @@
 #include <llvm/IR/InlineAsm.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Verifier.h>
@@ -23,6 +25,7 @@
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
 
 #include "thorin/config.h"
 #if THORIN_ENABLE_RV
@@ -34,6 +37,7 @@
 #include "thorin/primop.h"
 #include "thorin/type.h"
 #include "thorin/world.h"
+#include "thorin/analyses/alias.h"
 #include "thorin/analyses/schedule.h"
 #include "thorin/analyses/scope.h"
 #include "thorin/be/llvm/amdgpu.h"
@@ -64,21 +68,24 @@ CodeGen::CodeGen(World& world, llvm::CallingConv::ID function_calling_convention
 Continuation* CodeGen::emit_intrinsic(Continuation* continuation) {
     auto callee = continuation->callee()->as_continuation();
     switch (callee->intrinsic()) {
-        case Intrinsic::Atomic:    return emit_atomic(continuation);
-        case Intrinsic::CmpXchg:   return emit_cmpxchg(continuation);
-        case Intrinsic::Reserve:   return emit_reserve(continuation);
-        case Intrinsic::CUDA:      return runtime_->emit_host_code(*this, Runtime::CUDA_PLATFORM,   ".cu",   continuation);
-        case Intrinsic::NVVM:      return runtime_->emit_host_code(*this, Runtime::CUDA_PLATFORM,   ".nvvm", continuation);
-        case Intrinsic::OpenCL:    return runtime_->emit_host_code(*this, Runtime::OPENCL_PLATFORM, ".cl",   continuation);
-        case Intrinsic::AMDGPU:    return runtime_->emit_host_code(*this, Runtime::HSA_PLATFORM,    ".gcn",  continuation);
-        case Intrinsic::HLS:       return emit_hls(continuation);
-        case Intrinsic::Parallel:  return emit_parallel(continuation);
-        case Intrinsic::Spawn:     return emit_spawn(continuation);
-        case Intrinsic::Sync:      return emit_sync(continuation);
+        case Intrinsic::Atomic:      return emit_atomic(continuation);
+        case Intrinsic::CmpXchg:     return emit_cmpxchg(continuation);
+        case Intrinsic::Reserve:     return emit_reserve(continuation);
+        case Intrinsic::EnterRegion: return emit_enter_region(continuation);
+        case Intrinsic::LeaveRegion: return emit_leave_region(continuation);
+        case Intrinsic::Tile:        return continuation->args().back()->as_continuation();
+        case Intrinsic::CUDA:        return runtime_->emit_host_code(*this, Runtime::CUDA_PLATFORM,   ".cu",   continuation);
+        case Intrinsic::NVVM:        return runtime_->emit_host_code(*this, Runtime::CUDA_PLATFORM,   ".nvvm", continuation);
+        case Intrinsic::OpenCL:      return runtime_->emit_host_code(*this, Runtime::OPENCL_PLATFORM, ".cl",   continuation);
+        case Intrinsic::AMDGPU:      return runtime_->emit_host_code(*this, Runtime::HSA_PLATFORM,    ".gcn",  continuation);
+        case Intrinsic::HLS:         return emit_hls(continuation);
+        case Intrinsic::Parallel:    return emit_parallel(continuation);
+        case Intrinsic::Spawn:       return emit_spawn(continuation);
+        case Intrinsic::Sync:        return emit_sync(continuation);
 #if THORIN_ENABLE_RV
-        case Intrinsic::Vectorize: return emit_vectorize_continuation(continuation);
+        case Intrinsic::Vectorize:   return emit_vectorize_continuation(continuation);
 #else
-        case Intrinsic::Vectorize: throw std::runtime_error("rebuild with RV support");
+        case Intrinsic::Vectorize:   throw std::runtime_error("rebuild with RV support");
 #endif
         default: THORIN_UNREACHABLE;
     }
@@ -135,6 +142,22 @@ Continuation* CodeGen::emit_cmpxchg(Continuation* continuation) {
     return cont;
 }
 
+Continuation* CodeGen::emit_enter_region(Continuation* continuation) {
+    assert(continuation->num_args() == 2 && "required arguments are missing");
+    auto cont = continuation->arg(1)->as_continuation();
+    if (!cont->param(1)->type()->isa<PtrType>())
+        ELOG(cont->param(1), "enter_region: region must be of pointer type");
+    auto region = runtime_->region_enter(irbuilder_.getInt32(0));
+    emit_result_phi(cont->param(1), irbuilder_.CreatePointerCast(region, convert(cont->param(1)->type())));
+    return cont;
+}
+
+Continuation* CodeGen::emit_leave_region(Continuation* continuation) {
+    assert(continuation->num_args() == 3 && "required arguments are missing");
+    runtime_->region_leave(lookup(continuation->arg(1)));
+    return continuation->arg(2)->as_continuation();
+}
+
 Continuation* CodeGen::emit_reserve(const Continuation* continuation) {
     ELOG(&continuation->jump_debug(), "reserve_shared: only allowed in device code");
     THORIN_UNREACHABLE;
@@ -211,7 +234,193 @@ llvm::Function* CodeGen::emit_function_decl(Continuation* continuation) {
 
     return fcts_[continuation] = f;
 }
-std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
+void CodeGen::emit_counter(Continuation* continuation) {
+    auto type = irbuilder_.getInt64Ty();
+    auto counter = new llvm::GlobalVariable(*module_, type, false, llvm::GlobalValue::InternalLinkage,
+                                            llvm::ConstantInt::get(type, 0), "prof." + continuation->unique_name());
+    irbuilder_.CreateStore(irbuilder_.CreateAdd(irbuilder_.CreateLoad(counter), irbuilder_.getInt64(1)), counter);
+    counters_.emplace_back(continuation, counter);
+}
+
+/// Emits a function which appends all counters to "<name>.prof" and registers it via @c atexit in a module constructor.
+void CodeGen::emit_profile_dump() {
+    auto void_type = irbuilder_.getVoidTy();
+    auto ptr_type  = irbuilder_.getInt8PtrTy();
+    auto i32_type  = irbuilder_.getInt32Ty();
+    auto fn_type   = llvm::FunctionType::get(void_type, false);
+
+    auto fopen   = module_->getOrInsertFunction("fopen",   llvm::FunctionType::get(ptr_type, { ptr_type, ptr_type }, false));
+    auto fprintf = module_->getOrInsertFunction("fprintf", llvm::FunctionType::get(i32_type, { ptr_type, ptr_type }, true));
+    auto fclose  = module_->getOrInsertFunction("fclose",  llvm::FunctionType::get(i32_type, { ptr_type }, false));
+    auto atexit  = module_->getOrInsertFunction("atexit",  llvm::FunctionType::get(i32_type, { fn_type->getPointerTo() }, false));
+
+    auto dump = llvm::Function::Create(fn_type, llvm::GlobalValue::InternalLinkage, "thorin_profile_dump", module_.get());
+    auto bb = llvm::BasicBlock::Create(context_, "dump", dump);
+    auto done = llvm::BasicBlock::Create(context_, "done", dump);
+    auto exit = llvm::BasicBlock::Create(context_, "exit", dump);
+    irbuilder_.SetInsertPoint(bb);
+    auto file = irbuilder_.CreateCall(fopen, { irbuilder_.CreateGlobalStringPtr(world_.name() + ".prof"), irbuilder_.CreateGlobalStringPtr("a") });
+    irbuilder_.CreateCondBr(irbuilder_.CreateIsNull(file), exit, done);
+    irbuilder_.SetInsertPoint(done);
+    auto format = irbuilder_.CreateGlobalStringPtr("%llu %s\n");
+    for (const auto& p : counters_)
+        irbuilder_.CreateCall(fprintf, { file, format, irbuilder_.CreateLoad(p.second), irbuilder_.CreateGlobalStringPtr(Profile::key(p.first).str()) });
+    irbuilder_.CreateCall(fclose, { file });
+    irbuilder_.CreateBr(exit);
+    irbuilder_.SetInsertPoint(exit);
+    irbuilder_.CreateRetVoid();
+
+    auto ctor = llvm::Function::Create(fn_type, llvm::GlobalValue::InternalLinkage, "thorin_profile_init", module_.get());
+    irbuilder_.SetInsertPoint(llvm::BasicBlock::Create(context_, "init", ctor));
+    irbuilder_.CreateCall(atexit, { dump });
+    irbuilder_.CreateRetVoid();
+    llvm::appendToGlobalCtors(*module_, ctor, 0);
+
+    counters_.clear();
+}
+
+/**
+ * Attaches @c branch_weights to @p terminator if the @p Profile knows the counts of all @p targets.
+ * Otherwise, the weights are derived from an @p Expect hint, if given, which marks the @p expected targets.
+ */
+void CodeGen::emit_branch_weights(llvm::Instruction* terminator, ArrayRef<Continuation*> targets, ArrayRef<bool> expected) {
+    const auto& profile = world().profile();
+    std::vector<uint32_t> weights;
+
+    if (!profile.empty()) {
+        Array<u64> counts(targets.size());
+        u64 max = 0;
+        bool known = true;
+        for (size_t i = 0, e = targets.size(); i != e && known; ++i) {
+            known &= profile.lookup(targets[i], counts[i]);
+            max = std::max(max, counts[i]);
+        }
+
+        if (known) {
+            // weights are 32 bit
+            u64 scale = max / u64(std::numeric_limits<uint32_t>::max()) + 1;
+            for (auto count : counts)
+                weights.push_back(uint32_t(count / scale));
+        }
+    }
+
+    if (weights.empty() && !expected.empty()) {
+        assert(expected.size() == targets.size());
+        // same ratio as clang uses for __builtin_expect
+        for (auto b : expected)
+            weights.push_back(b ? 2000 : 1);
+    }
+
+    if (!weights.empty())
+        terminator->setMetadata(llvm::LLVMContext::MD_prof, llvm::MDBuilder(context_).createBranchWeights(weights));
+}
+
+static const Continuation* get_alloc_call(const Def* def) {
+    // look through casts and alignment hints
+    while (def->isa<ConvOp>() || def->isa<Aligned>())
+        def = def->op(0);
+
+    auto param = def->isa<Param>();
+    if (!param) return nullptr;
+
+    auto ret = param->continuation();
+    if (ret->num_uses() != 1) return nullptr;
+
+    auto use = *(ret->uses().begin());
+    auto call = use.def()->isa_continuation();
+    if (!call || use.index() == 0) return nullptr;
+
+    auto callee = call->callee();
+    if (callee->name() != "anydsl_alloc") return nullptr;
+
+    return call;
+}
+
+/// Do all pointers among @p args point to memory of distinct @c anydsl_alloc calls?
+static bool has_distinct_allocs(ArrayRef<const Def*> args) {
+    DefSet allocs;
+    for (auto arg : args) {
+        if (!arg->type()->isa<PtrType>()) continue;
+        auto alloc = get_alloc_call(arg);
+        if (!alloc || !allocs.insert(alloc).second)
+            return false;
+    }
+    return true;
+}
+
+/// Is @p continuation only ever called - directly or as the body of @c parallel, @c spawn or @c vectorize - with pointers to distinct allocations?
+static bool is_restrict(Continuation* continuation) {
+    if (continuation->is_external() || continuation->empty() || continuation->num_uses() == 0)
+        return false;
+
+    for (auto use : continuation->uses()) {
+        if (auto call = use->isa_continuation()) {
+            if (use.index() != 0 || !has_distinct_allocs(call->args()))
+                return false;
+        } else if (auto global = use->isa<Global>()) {
+            for (auto global_use : global->uses()) {
+                auto call = global_use->isa_continuation();
+                auto callee = call ? call->callee()->isa_continuation() : nullptr;
+                auto intrinsic = callee ? callee->intrinsic() : Intrinsic::None;
+                if (intrinsic != Intrinsic::Parallel && intrinsic != Intrinsic::Spawn && intrinsic != Intrinsic::Vectorize)
+                    return false;
+                // the body is followed by the return continuation and the args passed to the body
+                if (!has_distinct_allocs(call->args().skip_front(global_use.index() + 1)))
+                    return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Maps each @p Slot of @p block whose address is only loaded from and stored to within @p block to its last user there.
+ * Such a @p Slot lives from its definition up to this user; all others live throughout the function.
+ */
+static DefMap<const PrimOp*> block_local_slots(const Schedule::Block& block) {
+    DefMap<size_t> index;
+    for (auto primop : block)
+        index.emplace(primop, index.size());
+
+    DefMap<const PrimOp*> result;
+    for (auto primop : block) {
+        auto slot = primop->isa<Slot>();
+        if (slot == nullptr)
+            continue;
+
+        const PrimOp* last = nullptr;
+        bool local = true;
+        std::vector<const Def*> stack(1, slot);
+        while (local && !stack.empty()) {
+            auto def = stack.back();
+            stack.pop_back();
+
+            for (auto use : def->uses()) {
+                bool is_derived = use->isa<LEA>() || use->isa<Bitcast>();
+                bool is_access = (use->isa<Load>() || use->isa<Store>()) && use.index() == 1;
+                auto i = index.find(use.def());
+                if (i == index.end() || !((is_derived && use.index() == 0) || is_access)) {
+                    local = false;
+                    break;
+                }
+
+                if (last == nullptr || i->second > index[last])
+                    last = use->as<PrimOp>();
+                if (is_derived)
+                    stack.push_back(use.def());
+            }
+        }
+
+        if (local && last != nullptr)
+            result[slot] = last;
+    }
+
+    return result;
+}
+
+std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print, bool instrument) {
     llvm::DICompileUnit* dicompile_unit;
     if (debug) {
         module_->addModuleFlag(llvm::Module::Warning, "Debug Info Version", llvm::DEBUG_METADATA_VERSION);
@@ -242,6 +451,8 @@ std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
 
         // map params
         const Param* ret_param = nullptr;
+        std::vector<const Param*> noalias_params;
+        bool noalias = is_restrict(entry_);
         auto arg = fct->arg_begin();
         for (auto param : entry_->params()) {
             if (is_mem(param) || is_unit(param))
@@ -250,6 +461,10 @@ std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
                 auto argv = &*arg;
                 auto value = map_param(fct, argv, param);
                 if (value == argv) {
+                    if (noalias && param->type()->isa<PtrType>()) {
+                        arg->addAttr(llvm::Attribute::NoAlias);
+                        noalias_params.push_back(param);
+                    }
                     arg->setName(param->unique_name()); // use param
                     params_[param] = &*arg++;
                 } else {
@@ -262,6 +477,14 @@ std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
         }
         assert(ret_param);
 
+        // one alias scope per noalias param keeps its accesses apart from the other ones even after inlining
+        if (noalias_params.size() > 1) {
+            llvm::MDBuilder mdbuilder(context_);
+            auto domain = mdbuilder.createAnonymousAliasScopeDomain(fct->getName());
+            for (auto param : noalias_params)
+                scopes_[param] = mdbuilder.createAnonymousAliasScope(domain, param->unique_name());
+        }
+
         BBMap bb2continuation;
         Schedule schedule(scope);
 
@@ -297,6 +520,13 @@ std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
                 continue;
             assert(continuation == entry_ || continuation->is_basicblock());
             irbuilder_.SetInsertPoint(bb2continuation[continuation]);
+            if (instrument && !Profile::key(continuation).empty())
+                emit_counter(continuation);
+
+            DefMap<std::vector<const Slot*>> last2slots;
+            auto local_slots = block_local_slots(block);
+            for (const auto& p : local_slots)
+                last2slots[p.second].push_back(p.first->as<Slot>());
 
             for (auto primop : block) {
                 if (debug)
@@ -310,6 +540,15 @@ std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
 
                 auto llvm_value = emit(primop);
                 primops_[primop] = llvm_value;
+
+                // all slots live in the entry block - mark the lifetime of those which are only used here
+                if (primop->isa<Slot>() && local_slots.contains(primop))
+                    emit_lifetime(llvm::Intrinsic::lifetime_start, llvm::cast<llvm::AllocaInst>(llvm_value));
+                auto i = last2slots.find(primop);
+                if (i != last2slots.end()) {
+                    for (auto slot : i->second)
+                        emit_lifetime(llvm::Intrinsic::lifetime_end, llvm::cast<llvm::AllocaInst>(lookup(slot)));
+                }
             }
 
             // terminate bb
@@ -346,20 +585,34 @@ std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
                 }
             } else if (continuation->callee() == world().branch()) {
                 auto cond = lookup(continuation->arg(0));
-                auto tbb = bb2continuation[continuation->arg(1)->as_continuation()];
-                auto fbb = bb2continuation[continuation->arg(2)->as_continuation()];
-                irbuilder_.CreateCondBr(cond, tbb, fbb);
+                auto tcont = continuation->arg(1)->as_continuation();
+                auto fcont = continuation->arg(2)->as_continuation();
+                auto br = irbuilder_.CreateCondBr(cond, bb2continuation[tcont], bb2continuation[fcont]);
+                if (auto expect = continuation->arg(0)->isa<Expect>()) {
+                    bool b = expect->expected()->value().get_bool();
+                    emit_branch_weights(br, { tcont, fcont }, { b, !b });
+                } else
+                    emit_branch_weights(br, { tcont, fcont });
             } else if (continuation->callee()->isa<Continuation>() &&
                        continuation->callee()->as<Continuation>()->intrinsic() == Intrinsic::Match) {
                 auto val = lookup(continuation->arg(0));
-                auto otherwise_bb = bb2continuation[continuation->arg(1)->as_continuation()];
-                auto match = irbuilder_.CreateSwitch(val, otherwise_bb, continuation->num_args() - 2);
+                auto otherwise = continuation->arg(1)->as_continuation();
+                auto match = irbuilder_.CreateSwitch(val, bb2continuation[otherwise], continuation->num_args() - 2);
+                auto expect = continuation->arg(0)->isa<Expect>();
+                std::vector<Continuation*> targets(1, otherwise);
+                Array<bool> expected(expect ? continuation->num_args() - 1 : 0, false);
                 for (size_t i = 2; i < continuation->num_args(); i++) {
                     auto arg = continuation->arg(i)->as<Tuple>();
                     auto case_const = llvm::cast<llvm::ConstantInt>(lookup(arg->op(0)));
-                    auto case_bb    = bb2continuation[arg->op(1)->as_continuation()];
-                    match->addCase(case_const, case_bb);
+                    auto case_cont  = arg->op(1)->as_continuation();
+                    match->addCase(case_const, bb2continuation[case_cont]);
+                    targets.push_back(case_cont);
+                    if (expect && arg->op(0) == expect->expected())
+                        expected[i - 1] = true;
                 }
+                if (expect && std::find(expected.begin(), expected.end(), true) == expected.end())
+                    expected[0] = true;
+                emit_branch_weights(match, targets, expected);
             } else if (continuation->callee()->isa<Bottom>()) {
                 irbuilder_.CreateUnreachable();
             } else {
@@ -462,8 +715,12 @@ std::unique_ptr<llvm::Module>& CodeGen::emit(int opt, bool debug, bool print) {
         params_.clear();
         phis_.clear();
         primops_.clear();
+        scopes_.clear();
     });
 
+    if (!counters_.empty())
+        emit_profile_dump();
+
 #if THORIN_ENABLE_RV
     // emit vectorized code
     for (const auto& tuple : vec_todo_)
@@ -609,8 +866,19 @@ llvm::Value* CodeGen::emit(const Def* def) {
         if (auto arithop = bin->isa<ArithOp>()) {
             auto type = arithop->type();
             bool q = is_type_q(arithop->type()); // quick? -> nsw/nuw/fast float
+            bool nsw = arithop->is_nsw(), nuw = arithop->is_nuw(), exact = arithop->is_exact();
 
             if (is_type_f(type)) {
+                llvm::FastMathFlags fmf;
+                if (arithop->is_reassoc())  fmf.setAllowReassoc();
+                if (arithop->is_contract()) fmf.setAllowContract(true);
+                if (arithop->is_nnan())     fmf.setNoNaNs();
+                if (arithop->is_ninf())     fmf.setNoInfs();
+                if (arithop->is_nsz())      fmf.setNoSignedZeros();
+                if (arithop->is_arcp())     fmf.setAllowReciprocal();
+                llvm::IRBuilder<>::FastMathFlagGuard guard(irbuilder_);
+                irbuilder_.setFastMathFlags(fmf);
+
                 switch (arithop->arithop_tag()) {
                     case ArithOp_add: return irbuilder_.CreateFAdd(lhs, rhs, name);
                     case ArithOp_sub: return irbuilder_.CreateFSub(lhs, rhs, name);
@@ -627,30 +895,30 @@ llvm::Value* CodeGen::emit(const Def* def) {
 
             if (is_type_s(type) || is_type_bool(type)) {
                 switch (arithop->arithop_tag()) {
-                    case ArithOp_add: return irbuilder_.CreateAdd (lhs, rhs, name, false, q);
-                    case ArithOp_sub: return irbuilder_.CreateSub (lhs, rhs, name, false, q);
-                    case ArithOp_mul: return irbuilder_.CreateMul (lhs, rhs, name, false, q);
-                    case ArithOp_div: return irbuilder_.CreateSDiv(lhs, rhs, name);
+                    case ArithOp_add: return irbuilder_.CreateAdd (lhs, rhs, name, nuw, q || nsw);
+                    case ArithOp_sub: return irbuilder_.CreateSub (lhs, rhs, name, nuw, q || nsw);
+                    case ArithOp_mul: return irbuilder_.CreateMul (lhs, rhs, name, nuw, q || nsw);
+                    case ArithOp_div: return irbuilder_.CreateSDiv(lhs, rhs, name, exact);
                     case ArithOp_rem: return irbuilder_.CreateSRem(lhs, rhs, name);
                     case ArithOp_and: return irbuilder_.CreateAnd (lhs, rhs, name);
                     case ArithOp_or:  return irbuilder_.CreateOr  (lhs, rhs, name);
                     case ArithOp_xor: return irbuilder_.CreateXor (lhs, rhs, name);
-                    case ArithOp_shl: return irbuilder_.CreateShl (lhs, rhs, name, false, q);
-                    case ArithOp_shr: return irbuilder_.CreateAShr(lhs, rhs, name);
+                    case ArithOp_shl: return irbuilder_.CreateShl (lhs, rhs, name, nuw, q || nsw);
+                    case ArithOp_shr: return irbuilder_.CreateAShr(lhs, rhs, name, exact);
                 }
             }
             if (is_type_u(type) || is_type_bool(type)) {
                 switch (arithop->arithop_tag()) {
-                    case ArithOp_add: return irbuilder_.CreateAdd (lhs, rhs, name, q, false);
-                    case ArithOp_sub: return irbuilder_.CreateSub (lhs, rhs, name, q, false);
-                    case ArithOp_mul: return irbuilder_.CreateMul (lhs, rhs, name, q, false);
-                    case ArithOp_div: return irbuilder_.CreateUDiv(lhs, rhs, name);
+                    case ArithOp_add: return irbuilder_.CreateAdd (lhs, rhs, name, q || nuw, nsw);
+                    case ArithOp_sub: return irbuilder_.CreateSub (lhs, rhs, name, q || nuw, nsw);
+                    case ArithOp_mul: return irbuilder_.CreateMul (lhs, rhs, name, q || nuw, nsw);
+                    case ArithOp_div: return irbuilder_.CreateUDiv(lhs, rhs, name, exact);
                     case ArithOp_rem: return irbuilder_.CreateURem(lhs, rhs, name);
                     case ArithOp_and: return irbuilder_.CreateAnd (lhs, rhs, name);
                     case ArithOp_or:  return irbuilder_.CreateOr  (lhs, rhs, name);
                     case ArithOp_xor: return irbuilder_.CreateXor (lhs, rhs, name);
-                    case ArithOp_shl: return irbuilder_.CreateShl (lhs, rhs, name, q, false);
-                    case ArithOp_shr: return irbuilder_.CreateLShr(lhs, rhs, name);
+                    case ArithOp_shl: return irbuilder_.CreateShl (lhs, rhs, name, q || nuw, nsw);
+                    case ArithOp_shr: return irbuilder_.CreateLShr(lhs, rhs, name, exact);
                 }
             }
         }
@@ -728,6 +996,16 @@ llvm::Value* CodeGen::emit(const Def* def) {
             return emit_bitcast(conv->from(), dst_type);
     }
 
+    // the hint itself is attached to the branch or switch that uses it
+    if (auto expect = def->isa<Expect>())
+        return lookup(expect->value());
+
+    if (auto aligned = def->isa<Aligned>()) {
+        auto ptr = lookup(aligned->ptr());
+        irbuilder_.CreateAlignmentAssumption(module_->getDataLayout(), ptr, aligned->align());
+        return ptr;
+    }
+
     if (auto select = def->isa<Select>()) {
         if (def->type()->isa<FnType>())
             return nullptr;
@@ -887,21 +1165,24 @@ llvm::Value* CodeGen::emit(const Def* def) {
     if (auto bottom = def->isa<Bottom>())
         return llvm::UndefValue::get(convert(bottom->type()));
 
-    if (auto alloc = def->isa<Alloc>()) { // TODO factor this code
-        auto llvm_malloc = runtime_->get(get_alloc_name().c_str());
+    if (auto alloc = def->isa<Alloc>()) {
         auto alloced_type = convert(alloc->alloced_type());
-        llvm::CallInst* void_ptr;
         auto layout = module_->getDataLayout();
+        llvm::Value* size = irbuilder_.getInt64(layout.getTypeAllocSize(alloced_type));
         if (auto array = alloc->alloced_type()->isa<IndefiniteArrayType>()) {
-            auto size = irbuilder_.CreateAdd(
-                    irbuilder_.getInt64(layout.getTypeAllocSize(alloced_type)),
+            size = irbuilder_.CreateAdd(size,
                     irbuilder_.CreateMul(irbuilder_.CreateIntCast(lookup(alloc->extra()), irbuilder_.getInt64Ty(), false),
                                          irbuilder_.getInt64(layout.getTypeAllocSize(convert(array->elem_type())))));
-            llvm::Value* malloc_args[] = { irbuilder_.getInt32(0), size };
-            void_ptr = irbuilder_.CreateCall(llvm_malloc, malloc_args);
+        }
+
+        llvm::Value* void_ptr;
+        if (alloc->region() != nullptr) {
+            void_ptr = runtime_->region_alloc(lookup(alloc->region()), size);
         } else {
-            llvm::Value* malloc_args[] = { irbuilder_.getInt32(0), irbuilder_.getInt64(layout.getTypeAllocSize(alloced_type)) };
-            void_ptr = irbuilder_.CreateCall(llvm_malloc, malloc_args);
+            llvm::Value* malloc_args[] = { irbuilder_.getInt32(0), size };
+            void_ptr = irbuilder_.CreateCall(runtime_->get(get_alloc_name().c_str()), malloc_args);
+            if (auto align = get_alloc_alignment())
+                irbuilder_.CreateAlignmentAssumption(layout, void_ptr, align);
         }
 
         return irbuilder_.CreatePointerCast(void_ptr, convert(alloc->out_ptr_type()));
@@ -909,12 +1190,14 @@ llvm::Value* CodeGen::emit(const Def* def) {
 
     if (auto load = def->isa<Load>())           return emit_load(load);
     if (auto store = def->isa<Store>())         return emit_store(store);
+    if (auto prefetch = def->isa<Prefetch>())   return emit_prefetch(prefetch);
     if (auto lea = def->isa<LEA>())             return emit_lea(lea);
     if (auto assembly = def->isa<Assembly>())   return emit_assembly(assembly);
     if (def->isa<Enter>())                      return nullptr;
 
+    // a slot in a loop must not grow the stack in each iteration
     if (auto slot = def->isa<Slot>())
-        return irbuilder_.CreateAlloca(convert(slot->type()->as<PtrType>()->pointee()), 0, slot->unique_name());
+        return emit_alloca(convert(slot->type()->as<PtrType>()->pointee()), slot->unique_name());
 
     if (auto vector = def->isa<Vector>()) {
         llvm::Value* vec = llvm::UndefValue::get(convert(vector->type()));
@@ -947,11 +1230,100 @@ llvm::Value* CodeGen::emit_global(const Global* global) {
 }
 
 llvm::Value* CodeGen::emit_load(const Load* load) {
-    return irbuilder_.CreateLoad(lookup(load->ptr()));
+    auto result = irbuilder_.CreateLoad(lookup(load->ptr()));
+    if (auto align = access_alignment(load->ptr(), result->getType()))
+        result->setAlignment(align);
+    if (load->is_nontemporal())
+        set_nontemporal(result);
+    set_alias_scopes(result, load->ptr());
+    return result;
 }
 
 llvm::Value* CodeGen::emit_store(const Store* store) {
-    return irbuilder_.CreateStore(lookup(store->val()), lookup(store->ptr()));
+    auto val = lookup(store->val());
+    auto result = irbuilder_.CreateStore(val, lookup(store->ptr()));
+    if (auto align = access_alignment(store->ptr(), val->getType()))
+        result->setAlignment(align);
+    if (store->is_nontemporal())
+        set_nontemporal(result);
+    set_alias_scopes(result, store->ptr());
+    return result;
+}
+
+unsigned CodeGen::alignment(const Def* ptr) {
+    if (auto aligned = ptr->isa<Aligned>())
+        return std::max(aligned->align(), alignment(aligned->ptr()));
+    if (auto bitcast = ptr->isa<Bitcast>())
+        return bitcast->from()->type()->isa<PtrType>() ? alignment(bitcast->from()) : 0;
+    if (auto alloc = Alloc::is_out_ptr(ptr))
+        return alloc->region() == nullptr ? get_alloc_alignment() : 0;
+
+    if (auto lea = ptr->isa<LEA>()) {
+        auto align = alignment(lea->ptr());
+        if (align == 0)
+            return 0;
+
+        auto layout = module_->getDataLayout();
+        u64 offset;
+        if (lea->ptr_pointee()->isa<TupleType>() || lea->ptr_pointee()->isa<StructType>()) {
+            auto struct_type = llvm::cast<llvm::StructType>(convert(lea->ptr_pointee()));
+            offset = layout.getStructLayout(struct_type)->getElementOffset(primlit_value<u32>(lea->index()));
+        } else {
+            // the offset is a multiple of the element size and of any literal factor of the index
+            offset = layout.getTypeAllocSize(convert(lea->ptr_pointee()->as<ArrayType>()->elem_type()));
+            auto index = lea->index();
+            if (index->isa<PrimLit>()) {
+                offset *= primlit_value<u64>(index);
+            } else if (auto arithop = index->isa<ArithOp>()) {
+                if (arithop->arithop_tag() == ArithOp_mul) {
+                    if (arithop->lhs()->isa<PrimLit>())
+                        offset *= primlit_value<u64>(arithop->lhs());
+                    else if (arithop->rhs()->isa<PrimLit>())
+                        offset *= primlit_value<u64>(arithop->rhs());
+                } else if (arithop->arithop_tag() == ArithOp_shl && arithop->rhs()->isa<PrimLit>()) {
+                    offset <<= primlit_value<u64>(arithop->rhs());
+                }
+            }
+        }
+
+        // the largest power of 2 which divides the offset
+        return offset == 0 ? align : unsigned(std::min(u64(align), offset & -offset));
+    }
+
+    return 0;
+}
+
+unsigned CodeGen::access_alignment(const Def* ptr, llvm::Type* type) {
+    auto align = alignment(ptr);
+    return align > module_->getDataLayout().getABITypeAlignment(type) ? align : 0;
+}
+
+void CodeGen::set_nontemporal(llvm::Instruction* access) {
+    access->setMetadata(llvm::LLVMContext::MD_nontemporal, llvm::MDNode::get(context_, { llvm::ConstantAsMetadata::get(irbuilder_.getInt32(1)) }));
+}
+
+void CodeGen::set_alias_scopes(llvm::Instruction* access, const Def* ptr) {
+    auto param = MemLoc(ptr).object()->isa<Param>();
+    auto scope = param ? thorin::find(scopes_, param) : nullptr;
+    if (scope == nullptr)
+        return;
+
+    std::vector<llvm::Metadata*> others;
+    for (const auto& p : scopes_) {
+        if (p.second != scope)
+            others.push_back(p.second);
+    }
+    access->setMetadata(llvm::LLVMContext::MD_alias_scope, llvm::MDNode::get(context_, { scope }));
+    access->setMetadata(llvm::LLVMContext::MD_noalias, llvm::MDNode::get(context_, others));
+}
+
+llvm::Value* CodeGen::emit_prefetch(const Prefetch* prefetch) {
+    auto ptr = lookup(prefetch->ptr());
+    auto addr_space = ptr->getType()->getPointerAddressSpace();
+    auto void_cast = irbuilder_.CreateBitCast(ptr, llvm::PointerType::get(irbuilder_.getInt8Ty(), addr_space));
+    auto fn = llvm::Intrinsic::getDeclaration(module_.get(), llvm::Intrinsic::prefetch);
+    // the last argument selects the data cache
+    return irbuilder_.CreateCall(fn, { void_cast, irbuilder_.getInt32(prefetch->is_write()), irbuilder_.getInt32(prefetch->locality()), irbuilder_.getInt32(1) });
 }
 
 llvm::Value* CodeGen::emit_lea(const LEA* lea) {
@@ -1189,18 +1561,20 @@ llvm::Value* CodeGen::create_tmp_alloca(llvm::Type* type, std::function<llvm::Va
     auto alloca = emit_alloca(type, "tmp_alloca");
 
     // mark the lifetime of the alloca
-    auto lifetime_start = llvm::Intrinsic::getDeclaration(module_.get(), llvm::Intrinsic::lifetime_start);
-    auto lifetime_end   = llvm::Intrinsic::getDeclaration(module_.get(), llvm::Intrinsic::lifetime_end);
+    emit_lifetime(llvm::Intrinsic::lifetime_start, alloca);
+    auto result = fun(alloca);
+    emit_lifetime(llvm::Intrinsic::lifetime_end, alloca);
+    return result;
+}
+
+void CodeGen::emit_lifetime(llvm::Intrinsic::ID id, llvm::AllocaInst* alloca) {
+    auto lifetime = llvm::Intrinsic::getDeclaration(module_.get(), id);
     auto addr_space = alloca->getType()->getPointerAddressSpace();
     auto void_cast = irbuilder_.CreateBitCast(alloca, llvm::PointerType::get(irbuilder_.getInt8Ty(), addr_space));
 
     auto layout = llvm::DataLayout(module_->getDataLayout());
-    auto size = irbuilder_.getInt64(layout.getTypeAllocSize(type));
-
-    irbuilder_.CreateCall(lifetime_start, { size, void_cast });
-    auto result = fun(alloca);
-    irbuilder_.CreateCall(lifetime_end, { size, void_cast });
-    return result;
+    auto size = irbuilder_.getInt64(layout.getTypeAllocSize(alloca->getAllocatedType()));
+    irbuilder_.CreateCall(lifetime, { size, void_cast });
 }
 
 //------------------------------------------------------------------------------
@@ -1235,27 +1609,6 @@ static void get_kernel_configs(Importer& importer,
     }
 }
 
-static const Continuation* get_alloc_call(const Def* def) {
-    // look through casts
-    while (auto conv_op = def->isa<ConvOp>())
-        def = conv_op->op(0);
-
-    auto param = def->isa<Param>();
-    if (!param) return nullptr;
-
-    auto ret = param->continuation();
-    if (ret->num_uses() != 1) return nullptr;
-
-    auto use = *(ret->uses().begin());
-    auto call = use.def()->isa_continuation();
-    if (!call || use.index() == 0) return nullptr;
-
-    auto callee = call->callee();
-    if (callee->name() != "anydsl_alloc") return nullptr;
-
-    return call;
-}
-
 static uint64_t get_alloc_size(const Def* def) {
     auto call = get_alloc_call(def);
     if (!call) return 0;
@@ -1265,7 +1618,7 @@ static uint64_t get_alloc_size(const Def* def) {
     return size ? static_cast<uint64_t>(size->value().get_qu64()) : 0_u64;
 }
 
-void emit_llvm(World& world, int opt, bool debug) {
+void emit_llvm(World& world, int opt, bool debug, bool instrument) {
     Importer cuda(world);
     Importer nvvm(world);
     Importer opencl(world);
@@ -1308,16 +1661,7 @@ void emit_llvm(World& world, int opt, bool debug) {
         !amdgpu.world().empty()) {
         auto get_gpu_config = [&] (Continuation* use, Continuation* /* imported */) {
             // determine whether or not this kernel uses restrict pointers
-            bool has_restrict = true;
-            DefSet allocs;
-            for (size_t i = LaunchArgs::Num, e = use->num_args(); has_restrict && i != e; ++i) {
-                auto arg = use->arg(i);
-                if (!arg->type()->isa<PtrType>()) continue;
-                auto alloc = get_alloc_call(arg);
-                if (!alloc) has_restrict = false;
-                auto p = allocs.insert(alloc);
-                has_restrict &= p.second;
-            }
+            bool has_restrict = has_distinct_allocs(use->args().skip_front(LaunchArgs::Num));
 
             auto it_config = use->arg(LaunchArgs::Config)->as<Tuple>();
             if (it_config->op(0)->isa<PrimLit>() &&
@@ -1375,7 +1719,7 @@ void emit_llvm(World& world, int opt, bool debug) {
     world.cleanup();
     codegen_prepare(world);
 
-    CPUCodeGen(world).emit(opt, debug);
+    CPUCodeGen(world).emit(opt, debug, true, instrument);
 
     if (!cuda.  world().empty()) CUDACodeGen  (cuda  .world(), kernel_config).emit(/*opt,*/ debug);
     if (!nvvm.  world().empty()) NVVMCodeGen  (nvvm  .world(), kernel_config).emit(opt, debug);
@@ -22,7 +22,8 @@ protected:
 
 public:
     World& world() const { return world_; }
-    std::unique_ptr<llvm::Module>& emit(int opt, bool debug, bool print = true);
+    /// If @p instrument is set, every block with a location counts its executions; the counts are appended to "<name>.prof" at exit (see @p Profile).
+    std::unique_ptr<llvm::Module>& emit(int opt, bool debug, bool print = true, bool instrument = false);
 
 protected:
     void optimize(int opt);
@@ -43,10 +44,13 @@ protected:
     virtual llvm::Value* emit_global(const Global*);
     virtual llvm::Value* emit_load(const Load*);
     virtual llvm::Value* emit_store(const Store*);
+    virtual llvm::Value* emit_prefetch(const Prefetch*);
     virtual llvm::Value* emit_lea(const LEA*);
     virtual llvm::Value* emit_assembly(const Assembly* assembly);
 
     virtual std::string get_alloc_name() const = 0;
+    /// The alignment in bytes of the memory returned by the function given by @p get_alloc_name or @c 0 if unknown.
+    virtual unsigned get_alloc_alignment() const { return 0; }
     virtual std::string get_output_name(const std::string& name) const = 0;
     llvm::GlobalVariable* emit_global_variable(llvm::Type*, const std::string&, unsigned, bool=false);
     Continuation* emit_reserve_shared(const Continuation*, bool=false);
@@ -61,14 +65,29 @@ private:
     Continuation* emit_vectorize_continuation(Continuation*);
     Continuation* emit_atomic(Continuation*);
     Continuation* emit_cmpxchg(Continuation*);
+    Continuation* emit_enter_region(Continuation*);
+    Continuation* emit_leave_region(Continuation*);
     llvm::Value* emit_bitcast(const Def*, const Type*);
     virtual Continuation* emit_reserve(const Continuation*);
     void emit_result_phi(const Param*, llvm::Value*);
+    void emit_counter(Continuation*);
+    void emit_profile_dump();
+    void emit_branch_weights(llvm::Instruction*, ArrayRef<Continuation*> targets, ArrayRef<bool> expected = ArrayRef<bool>());
     void emit_vectorize(u32, u32, llvm::Function*, llvm::CallInst*);
 
 protected:
     void create_loop(llvm::Value*, llvm::Value*, llvm::Value*, llvm::Function*, std::function<void(llvm::Value*)>);
     llvm::Value* create_tmp_alloca(llvm::Type*, std::function<llvm::Value* (llvm::AllocaInst*)>);
+    /// Emits a call to @c llvm.lifetime.start or @c llvm.lifetime.end - as given by @p id - for the whole @p alloca.
+    void emit_lifetime(llvm::Intrinsic::ID id, llvm::AllocaInst* alloca);
+    /// Attaches @c !nontemporal to the load or store @p access.
+    void set_nontemporal(llvm::Instruction* access);
+    /// Attaches @c !alias.scope and @c !noalias to the load or store @p access if @p ptr is derived from a @c noalias param.
+    void set_alias_scopes(llvm::Instruction* access, const Def* ptr);
+    /// The alignment in bytes @p ptr is known to have from @p Aligned hints and allocations or @c 0 if unknown.
+    unsigned alignment(const Def* ptr);
+    /// The alignment for an access of @p type via @p ptr if it exceeds the ABI alignment of @p type - @c 0 otherwise.
+    unsigned access_alignment(const Def* ptr, llvm::Type* type);
 
     World& world_;
     llvm::LLVMContext context_;
@@ -81,6 +100,7 @@ protected:
     ParamMap<llvm::Value*> params_;
     ParamMap<llvm::PHINode*> phis_;
     PrimOpMap<llvm::Value*> primops_;
+    ParamMap<llvm::MDNode*> scopes_; ///< Alias scope of each @c noalias param of the current function.
     ContinuationMap<llvm::Function*> fcts_;
     TypeMap<llvm::Type*> types_;
 #if THORIN_ENABLE_RV
@@ -88,6 +108,7 @@ protected:
 #endif
 
     std::unique_ptr<Runtime> runtime_;
+    std::vector<std::pair<Continuation*, llvm::GlobalVariable*>> counters_;
     Continuation* entry_ = nullptr;
 
     friend class Runtime;
@@ -98,7 +119,7 @@ protected:
 template<class T>
 llvm::ArrayRef<T> llvm_ref(const Array<T>& array) { return llvm::ArrayRef<T>(array.begin(), array.end()); }
 
-void emit_llvm(World& world, int opt, bool debug);
+void emit_llvm(World& world, int opt, bool debug, bool instrument = false);
 
 } // namespace thorin
 
@@ -19,6 +19,7 @@ protected:
     virtual llvm::Value* emit_global(const Global*) override;
     virtual llvm::Value* emit_load(const Load*) override;
     virtual llvm::Value* emit_store(const Store*) override;
+    virtual llvm::Value* emit_prefetch(const Prefetch*) override { return nullptr; } // not supported by NVPTX
     virtual llvm::Value* emit_lea(const LEA*) override;
     virtual Continuation* emit_reserve(const Continuation*) override;
     virtual std::string get_alloc_name() const override { return "malloc"; }
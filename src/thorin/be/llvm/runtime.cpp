@@ -199,4 +199,17 @@ llvm::Value* Runtime::sync_thread(llvm::Value* id) {
     return builder_.CreateCall(get("anydsl_sync_thread"), id);
 }
 
+llvm::Value* Runtime::region_enter(llvm::Value* device) {
+    return builder_.CreateCall(get("anydsl_region_enter"), device);
+}
+
+llvm::Value* Runtime::region_alloc(llvm::Value* region, llvm::Value* size) {
+    llvm::Value* alloc_args[] = { builder_.CreatePointerCast(region, builder_.getInt8PtrTy()), size };
+    return builder_.CreateCall(get("anydsl_region_alloc"), alloc_args);
+}
+
+llvm::Value* Runtime::region_leave(llvm::Value* region) {
+    return builder_.CreateCall(get("anydsl_region_leave"), builder_.CreatePointerCast(region, builder_.getInt8PtrTy()));
+}
+
 }
@@ -52,6 +52,13 @@ public:
     /// Emits a call to anydsl_sync_thread.
     llvm::Value* sync_thread(llvm::Value* id);
 
+    /// Emits a call to anydsl_region_enter which returns a handle to a fresh bump allocator on @p device.
+    llvm::Value* region_enter(llvm::Value* device);
+    /// Emits a call to anydsl_region_alloc.
+    llvm::Value* region_alloc(llvm::Value* region, llvm::Value* size);
+    /// Emits a call to anydsl_region_leave which releases everything allocated in @p region.
+    llvm::Value* region_leave(llvm::Value* region);
+
     Continuation* emit_host_code(CodeGen& code_gen,
                                  Platform platform,
                                  const std::string& ext,
@@ -190,6 +190,12 @@ void CodeGen::emit_vectorize(u32 vector_length, u32 alignment, llvm::Function* k
         vectorizer.finalize();
     }
 
+    // keep the noalias params of the kernel - inlining turns them into alias scopes
+    for (auto src = kernel_func->arg_begin(), dst = simd_kernel_func->arg_begin(), end = kernel_func->arg_end(); src != end; ++src, ++dst) {
+        if (src->hasNoAliasAttr())
+            dst->addAttr(llvm::Attribute::NoAlias);
+    }
+
     // inline kernel
     llvm::InlineFunctionInfo info;
     llvm::InlineFunction(simd_kernel_call, info);
@@ -196,6 +196,9 @@ void Continuation::set_intrinsic() {
     else if (name() == "atomic")               intrinsic_ = Intrinsic::Atomic;
     else if (name() == "cmpxchg")              intrinsic_ = Intrinsic::CmpXchg;
     else if (name() == "undef")                intrinsic_ = Intrinsic::Undef;
+    else if (name() == "enter_region")         intrinsic_ = Intrinsic::EnterRegion;
+    else if (name() == "leave_region")         intrinsic_ = Intrinsic::LeaveRegion;
+    else if (name() == "tile")                 intrinsic_ = Intrinsic::Tile;
     else ELOG(this, "unsupported thorin intrinsic");
 }
 
@@ -324,171 +327,17 @@ Continuation* Continuation::update_op(size_t i, const Def* def) {
  * value numbering
  */
 
-const Def* Continuation::find_def(size_t handle) {
-    increase_values(handle);
-    return values_[handle];
-}
-
-const Def* Continuation::set_mem(const Def* def) { return set_value(0, def); }
-const Def* Continuation::get_mem() { return get_value(0, world().mem_type(), { "mem" }); }
-
-const Def* Continuation::set_value(size_t handle, const Def* def) {
-    increase_values(handle);
-    return values_[handle] = def;
-}
-
-const Def* Continuation::get_value(size_t handle, const Type* type, Debug dbg) {
-    auto result = find_def(handle);
-    if (result)
-        goto return_result;
-
-    if (parent() != this) { // is a function head?
-        if (parent()) {
-            result = parent()->get_value(handle, type, dbg);
-            goto return_result;
-        }
-    } else {
-        if (!is_sealed_) {
-            auto param = append_param(type, dbg);
-            todos_.emplace_back(handle, param->index(), type, dbg);
-            result = set_value(handle, param);
-            goto return_result;
-        }
-
-        Continuations preds = this->preds();
-        switch (preds.size()) {
-            case 0:
-                goto return_bottom;
-            case 1:
-                result = set_value(handle, preds.front()->get_value(handle, type, dbg));
-                goto return_result;
-            default: {
-                if (is_visited_) {
-                    result = set_value(handle, append_param(type, dbg)); // create param to break cycle
-                    goto return_result;
-                }
-
-                is_visited_ = true;
-                const Def* same = nullptr;
-                for (auto pred : preds) {
-                    auto def = pred->get_value(handle, type, dbg);
-                    if (same && same != def) {
-                        same = (const Def*)-1; // defs from preds are different
-                        break;
-                    }
-                    same = def;
-                }
-                assert(same != nullptr);
-                is_visited_ = false;
-
-                // fix any params which may have been introduced to break the cycle above
-                const Def* def = nullptr;
-                if (auto found = find_def(handle))
-                    def = fix(handle, found->as<Param>()->index(), type, dbg);
-
-                if (same != (const Def*)-1) {
-                    result = same;
-                    goto return_result;
-                }
-
-                if (def) {
-                    result = set_value(handle, def);
-                    goto return_result;
-                }
-
-                auto param = append_param(type, dbg);
-                set_value(handle, param);
-                fix(handle, param->index(), type, dbg);
-                result = param;
-                goto return_result;
-            }
-        }
-    }
-
-return_bottom:
-    WLOG(&dbg, "'{}' may be undefined", dbg.name());
-    return set_value(handle, world().bottom(type));
-
-return_result:
-    assert(result->type() == type);
-    return result;
-}
-
-void Continuation::seal() {
-    assert(!is_sealed() && "already sealed");
-    is_sealed_ = true;
-
-    for (const auto& todo : todos_)
-        fix(todo.handle(), todo.index(), todo.type(), todo.debug());
-    todos_.clear();
-}
-
-const Def* Continuation::fix(size_t handle, size_t index, const Type* type, Debug dbg) {
-    auto param = this->param(index);
-
-    assert(is_sealed() && "must be sealed");
-    assert(index == param->index());
-
-    for (auto pred : preds()) {
-        assert(!pred->empty());
-        //assert(pred->direct_succs().size() == 1 && "critical edge");
-        auto def = pred->get_value(handle, type, dbg);
-
-        // make potentially room for the new arg
-        if (index >= pred->num_args())
-            pred->resize(index+2);
-
-        assert(!pred->arg(index) && "already set");
-        pred->set_op(index + 1, def);
-    }
-
-    return try_remove_trivial_param(param);
-}
-
-const Def* Continuation::try_remove_trivial_param(const Param* param) {
-    assert(param->continuation() == this);
-    assert(is_sealed() && "must be sealed");
-
-    Continuations preds = this->preds();
-    size_t index = param->index();
-
-    // find Horspool-like phis
-    const Def* same = nullptr;
-    for (auto pred : preds) {
-        auto def = pred->arg(index);
-        if (def == param || same == def)
-            continue;
-        if (same)
-            return param;
-        same = def;
-    }
-    assert(same != nullptr);
-    param->replace(same);
-
-    for (auto peek : param->peek()) {
-        auto continuation = peek.from();
-        continuation->unset_op(index+1);
-        continuation->set_op(index+1, world().bottom(param->type(), param->debug()));
-    }
-
-    for (auto use : same->uses()) {
-        if (Continuation* continuation = use->isa_continuation()) {
-            for (auto succ : continuation->succs()) {
-                size_t index = -1;
-                for (size_t i = 0, e = succ->num_args(); i != e; ++i) {
-                    if (succ->arg(i) == use.def()) {
-                        index = i;
-                        break;
-                    }
-                }
-                if (index != size_t(-1) && param != succ->param(index))
-                    succ->try_remove_trivial_param(succ->param(index));
-            }
-        }
-    }
-
-    return same;
-}
+const Def* Continuation::set_value(size_t handle, const Def* def) { return world().ssa_builder().set_value(this, handle, def); }
+const Def* Continuation::get_value(size_t handle, const Type* type, Debug dbg) { return world().ssa_builder().get_value(this, handle, type, dbg); }
+const Def* Continuation::set_mem(const Def* def) { return world().ssa_builder().set_mem(this, def); }
+const Def* Continuation::get_mem() { return world().ssa_builder().get_mem(this); }
+Continuation* Continuation::parent() const { return world().ssa_builder().parent(this); }
+void Continuation::set_parent(Continuation* parent) { world().ssa_builder().set_parent(this, parent); }
+void Continuation::seal() { world().ssa_builder().seal(this); }
+bool Continuation::is_sealed() const { return world().ssa_builder().is_sealed(this); }
+void Continuation::unseal() { world().ssa_builder().unseal(this); }
+void Continuation::clear_value_numbering_table() { world().ssa_builder().clear_values(this); }
+bool Continuation::is_cleared() const { return world().ssa_builder().is_cleared(this); }
 
 std::ostream& Continuation::stream_head(std::ostream& os) const {
     os << unique_name();
@@ -543,9 +392,6 @@ bool is_passed_to_intrinsic(Continuation* cont, Intrinsic intrinsic) {
     return visit_capturing_intrinsics(cont, [&] (Continuation* continuation) { return continuation->intrinsic() == intrinsic; });
 }
 
-void clear_value_numbering_table(World& world) {
-    for (auto continuation : world.continuations())
-        continuation->clear_value_numbering_table();
-}
+void clear_value_numbering_table(World& world) { world.ssa_builder().clear_values(); }
 
 }
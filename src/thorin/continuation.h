@@ -83,6 +83,9 @@ enum class Intrinsic : uint8_t {
     Atomic,                     ///< Intrinsic atomic function
     CmpXchg,                    ///< Intrinsic cmpxchg function
     Undef,                      ///< Intrinsic undef function
+    EnterRegion,                ///< Opens a region for @p Alloc%s: enter_region(mem, (mem, region)).
+    LeaveRegion,                ///< Releases all @p Alloc%s of a region at once: leave_region(mem, region, (mem)).
+    Tile,                       ///< Requests @p loop_tiling for the loop nest entered next: tile(mem, outer, inner, (mem)).
     Branch,                     ///< branch(cond, T, F).
     Match,                      ///< match(val, otherwise, (case1, cont1), (case2, cont2), ...)
     PeInfo,                     ///< Partial evaluation debug info.
@@ -102,13 +105,10 @@ enum class CC : uint8_t {
  */
 class Continuation : public Def {
 private:
-    Continuation(const FnType* fn, CC cc, Intrinsic intrinsic, bool is_sealed, Debug dbg)
+    Continuation(const FnType* fn, CC cc, Intrinsic intrinsic, Debug dbg)
         : Def(Node_Continuation, fn, 0, dbg)
-        , parent_(this)
         , cc_(cc)
         , intrinsic_(intrinsic)
-        , is_sealed_(is_sealed)
-        , is_visited_(false)
     {
         params_.reserve(fn->num_ops());
         contains_continuation_ = true;
@@ -186,73 +186,31 @@ public:
     const Def* filter(size_t i) const { return filter_[i]; }
 
 
-    // value numbering
+    // value numbering - forwards to the SSABuilder of this Continuation's World
 
     const Def* set_value(size_t handle, const Def* def);
     const Def* get_value(size_t handle, const Type* type, Debug dbg = {});
     const Def* set_mem(const Def* def);
     const Def* get_mem();
-    Continuation* parent() const { return parent_; }            ///< See @p parent_ for more information.
-    void set_parent(Continuation* parent) { parent_ = parent; } ///< See @p parent_ for more information.
+    Continuation* parent() const;                   ///< See @p SSABuilder::Block::parent for more information.
+    void set_parent(Continuation* parent);          ///< See @p SSABuilder::Block::parent for more information.
     void seal();
-    bool is_sealed() const { return is_sealed_; }
-    void unseal() { is_sealed_ = false; }
-    void clear_value_numbering_table() { values_.clear(); }
-    bool is_cleared() { return values_.empty(); }
+    bool is_sealed() const;
+    void unseal();
+    void clear_value_numbering_table();
+    bool is_cleared() const;
 
 private:
-    class Todo {
-    public:
-        Todo() {}
-        Todo(size_t handle, size_t index, const Type* type, Debug dbg)
-            : handle_(handle)
-            , index_(index)
-            , type_(type)
-            , debug_(dbg)
-        {}
-
-        size_t handle() const { return handle_; }
-        size_t index() const { return index_; }
-        const Type* type() const { return type_; }
-        Debug debug() const { return debug_; }
-
-    private:
-        size_t handle_;
-        size_t index_;
-        const Type* type_;
-        Debug debug_;
-    };
-
-    const Def* fix(size_t handle, size_t index, const Type* type, Debug dbg);
-    const Def* try_remove_trivial_param(const Param*);
-    const Def* find_def(size_t handle);
-    void increase_values(size_t handle) { if (handle >= values_.size()) values_.resize(handle+1); }
-
     mutable Debug jump_debug_;
-
-    /**
-     * There exist three cases to distinguish here.
-     * - @p parent_ == this: This @p Continuation is considered as a basic block, i.e.,
-     *                       SSA construction will propagate value through this @p Continuation's predecessors.
-     * - @p parent_ == nullptr: This @p Continuation is considered as top level function, i.e.,
-     *                          SSA construction will stop propagate values here.
-     *                          Any @p get_value which arrives here without finding a definition will return @p bottom.
-     * - otherwise: This @p Continuation is considered as function head nested in @p parent_.
-     *              Any @p get_value which arrives here without finding a definition will recursively try to find one in @p parent_.
-     */
-    Continuation* parent_;
     std::vector<const Param*> params_;
     Array<const Def*> filter_; ///< used during @p partial_evaluation
-    std::deque<Tracker> values_;
-    std::vector<Todo> todos_;
     CC cc_;
     Intrinsic intrinsic_;
-    bool is_sealed_  : 1;
-    bool is_visited_ : 1;
 
     friend class Cleaner;
     friend class Scope;
     friend class CFA;
+    friend class SSABuilder;
     friend class World;
 };
 
@@ -131,18 +131,46 @@ void Def::replace(Tracker with) const {
     assert(!is_replaced());
 
     if (this != with) {
-        for (auto& use : copy_uses()) {
-            auto def = const_cast<Def*>(use.def());
-            auto index = use.index();
-            def->unset_op(index);
-            def->set_op(index, with);
-        }
-
-        uses_.clear();
+        rewire_uses(with);
         substitute_ = with;
     }
 }
 
+void Def::rewire_uses(const Def* with) const {
+    // our own use-list is dropped as a whole, so there is no need to unregister each use individually
+    with->uses_.reserve(with->num_uses() + num_uses());
+    for (auto use : uses_) {
+        auto def = const_cast<Def*>(use.def());
+        auto index = use.index();
+        assert(def->ops_[index] == this);
+        def->ops_[index] = with;
+        def->contains_continuation_ |= with->contains_continuation();
+        const auto& p = with->uses_.emplace(index, def);
+        assert_unused(p.second);
+    }
+
+    uses_.clear();
+}
+
+void replace_all(Defs olds, Defs news) {
+    assert(olds.size() == news.size());
+
+    for (size_t i = 0, e = olds.size(); i != e; ++i) {
+        auto old = olds[i];
+        auto with = Tracker(news[i]).def();
+        DLOG("replace: {} -> {}", old, with);
+        assert(old->type() == with->type());
+        assert(!old->is_replaced());
+        if (old != with)
+            old->substitute_ = with;
+    }
+
+    for (auto old : olds) {
+        if (old->is_replaced())
+            old->rewire_uses(Tracker(old).def());
+    }
+}
+
 void Def::dump() const {
     auto primop = this->isa<PrimOp>();
     if (primop && !is_const(primop))
@@ -108,6 +108,7 @@ protected:
     void unregister_use(size_t i) const;
     void unregister_uses() const;
     void resize(size_t n) { ops_.resize(n, nullptr); }
+    void rewire_uses(const Def* with) const;
 
 public:
     NodeTag tag() const { return tag_; }
@@ -160,8 +161,16 @@ protected:
     friend class Scope;
     friend class Tracker;
     friend class World;
+    friend void replace_all(Defs, Defs);
 };
 
+/**
+ * Replaces each of @p olds with the corresponding def in @p news in one go.
+ * All replacements are registered before any use is rewired, so a def in @p news which is itself replaced
+ * within this batch is resolved to its final substitute right away.
+ */
+void replace_all(Defs olds, Defs news);
+
 class Tracker {
 public:
     Tracker()
@@ -174,9 +183,17 @@ public:
     operator const Def*() { return def(); }
     const Def* operator->() { return def(); }
     const Def* def() {
-        if (def_ != nullptr) {
-            while (auto repr = def_->substitute_)
-                def_ = repr;
+        if (def_ != nullptr && def_->substitute_ != nullptr) {
+            auto repr = def_;
+            while (repr->substitute_ != nullptr)
+                repr = repr->substitute_;
+
+            // path compression: let all defs on the chain point directly to the representative
+            while (def_ != repr) {
+                auto next = def_->substitute_;
+                def_->substitute_ = repr;
+                def_ = next;
+            }
         }
         return def_;
     }
@@ -44,4 +44,16 @@ CmpTag negate(CmpTag tag) {
     THORIN_UNREACHABLE;
 }
 
+CmpTag commute(CmpTag tag) {
+    switch (tag) {
+        case Cmp_eq: return Cmp_eq;
+        case Cmp_ne: return Cmp_ne;
+        case Cmp_lt: return Cmp_gt;
+        case Cmp_le: return Cmp_ge;
+        case Cmp_gt: return Cmp_lt;
+        case Cmp_ge: return Cmp_le;
+    }
+    THORIN_UNREACHABLE;
+}
+
 } // namespace thorin
@@ -98,6 +98,7 @@ const char* tag2str(NodeTag tag);
 int num_bits(PrimTypeTag);
 
 CmpTag negate(CmpTag tag);
+CmpTag commute(CmpTag tag);
 
 } // namespace thorin
 
@@ -53,7 +53,7 @@ bool Value::use_lea() const {
 const Def* Value::load(Debug dbg) const {
     switch (tag()) {
         case ImmutableValRef: return def_;
-        case MutableValRef:   return builder_->cur_bb->get_value(handle_, type_, dbg);
+        case MutableValRef:   return builder_->ssa_builder().get_value(builder_->cur_bb, handle_, type_, dbg);
         case PtrRef:          return builder_->load(def_, dbg);
         case AggRef:          return builder_->extract(value_->load(dbg), def_, dbg);
         default: THORIN_UNREACHABLE;
@@ -62,7 +62,7 @@ const Def* Value::load(Debug dbg) const {
 
 void Value::store(const Def* val, Debug dbg) const {
     switch (tag()) {
-        case MutableValRef: builder_->cur_bb->set_value(handle_, val); return;
+        case MutableValRef: builder_->ssa_builder().set_value(builder_->cur_bb, handle_, val); return;
         case PtrRef:        builder_->store(def_, val, dbg); return;
         case AggRef:        value_->store(world().insert(value_->load(dbg), def_, val, dbg), dbg); return;
         default: THORIN_UNREACHABLE;
@@ -116,6 +116,8 @@ Continuation* JumpTarget::enter_unsealed(World& world) {
 
 //------------------------------------------------------------------------------
 
+SSABuilder& IRBuilder::ssa_builder() const { return world().ssa_builder(); }
+
 Continuation* IRBuilder::continuation(Debug dbg) {
     return continuation(world().fn_type(), CC::C, Intrinsic::None, dbg);
 }
@@ -124,7 +126,7 @@ Continuation* IRBuilder::continuation(const FnType* fn, CC cc, Intrinsic intrins
     auto l = world().continuation(fn, cc, intrinsic, dbg);
     if (fn->num_ops() >= 1 && fn->ops().front()->isa<MemType>()) {
         auto param = l->params().front();
-        l->set_mem(param);
+        ssa_builder().set_mem(l, param);
         if (param->debug().name().empty())
             param->debug().set("mem");
     }
@@ -182,8 +184,8 @@ const Def* IRBuilder::call(const Def* to, Defs args, const Type* ret_type, Debug
     return nullptr;
 }
 
-const Def* IRBuilder::get_mem() { return cur_bb->get_mem(); }
-void IRBuilder::set_mem(const Def* mem) { if (is_reachable()) cur_bb->set_mem(mem); }
+const Def* IRBuilder::get_mem() { return ssa_builder().get_mem(cur_bb); }
+void IRBuilder::set_mem(const Def* mem) { if (is_reachable()) ssa_builder().set_mem(cur_bb, mem); }
 
 const Def* IRBuilder::create_frame(Debug dbg) {
     auto enter = world().enter(get_mem(), dbg);
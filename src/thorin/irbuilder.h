@@ -12,6 +12,7 @@ namespace thorin {
 class IRBuilder;
 class Continuation;
 class Slot;
+class SSABuilder;
 class World;
 
 //------------------------------------------------------------------------------
@@ -122,6 +123,7 @@ public:
     {}
 
     World& world() const { return world_; }
+    SSABuilder& ssa_builder() const;
     bool is_reachable() const { return cur_bb != nullptr; }
     void set_unreachable() { cur_bb = nullptr; }
     const Def* create_frame(Debug);
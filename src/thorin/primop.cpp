@@ -100,15 +100,15 @@ Global::Global(const Def* init, bool is_mutable, Debug dbg)
     assert(is_const(init));
 }
 
-Alloc::Alloc(const Type* type, const Def* mem, const Def* extra, Debug dbg)
-    : MemOp(Node_Alloc, nullptr, {mem, extra}, dbg)
+Alloc::Alloc(const Type* type, const Def* mem, const Def* extra, const Def* region, Debug dbg)
+    : MemOp(Node_Alloc, nullptr, region != nullptr ? Defs({mem, extra, region}) : Defs({mem, extra}), dbg)
 {
     World& w = mem->world();
     set_type(w.tuple_type({w.mem_type(), w.ptr_type(type)}));
 }
 
-Load::Load(const Def* mem, const Def* ptr, Debug dbg)
-    : Access(Node_Load, nullptr, {mem, ptr}, dbg)
+Load::Load(const Def* mem, const Def* ptr, Flags flags, Debug dbg)
+    : Access(Node_Load, nullptr, {mem, ptr}, flags, dbg)
 {
     World& w = mem->world();
     set_type(w.tuple_type({w.mem_type(), ptr->type()->as<PtrType>()->pointee()}));
@@ -143,6 +143,8 @@ uint64_t PrimOp::vhash() const {
     return seed;
 }
 
+uint64_t ArithOp::vhash() const { return hash_combine(PrimOp::vhash(), uint32_t(flags())); }
+uint64_t Aligned::vhash() const { return hash_combine(PrimOp::vhash(), align()); }
 uint64_t PrimLit::vhash() const { return hash_combine(Literal::vhash(), bcast<uint64_t, Box>(value())); }
 uint64_t Slot::vhash() const { return hash_combine((int) tag(), gid()); }
 
@@ -159,6 +161,14 @@ bool PrimOp::equal(const PrimOp* other) const {
     return result;
 }
 
+bool ArithOp::equal(const PrimOp* other) const {
+    return PrimOp::equal(other) ? this->flags() == other->as<ArithOp>()->flags() : false;
+}
+
+bool Aligned::equal(const PrimOp* other) const {
+    return PrimOp::equal(other) ? this->align() == other->as<Aligned>()->align() : false;
+}
+
 bool PrimLit::equal(const PrimOp* other) const {
     return Literal::equal(other) ? this->value() == other->as<PrimLit>()->value() : false;
 }
@@ -173,12 +183,14 @@ bool Slot::equal(const PrimOp* other) const { return this == other; }
 
 // do not use any of PrimOp's type getters - during import we need to derive types from 't' in the new world 'to'
 
-const Def* ArithOp::vrebuild(World& to, Defs ops, const Type*  ) const { return to.arithop(arithop_tag(), ops[0], ops[1], debug()); }
+const Def* ArithOp::vrebuild(World& to, Defs ops, const Type*  ) const { return to.arithop(arithop_tag(), ops[0], ops[1], debug(), flags()); }
+const Def* Aligned::vrebuild(World& to, Defs ops, const Type*  ) const { return to.aligned(ops[0], align(), debug()); }
 const Def* Bitcast::vrebuild(World& to, Defs ops, const Type* t) const { return to.bitcast(t, ops[0], debug()); }
 const Def* Bottom ::vrebuild(World& to, Defs,     const Type* t) const { return to.bottom(t, debug()); }
 const Def* Cast   ::vrebuild(World& to, Defs ops, const Type* t) const { return to.cast(t, ops[0], debug()); }
 const Def* Cmp    ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.cmp(cmp_tag(), ops[0], ops[1], debug()); }
 const Def* Enter  ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.enter(ops[0], debug()); }
+const Def* Expect ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.expect(ops[0], ops[1], debug()); }
 const Def* Extract::vrebuild(World& to, Defs ops, const Type*  ) const { return to.extract(ops[0], ops[1], debug()); }
 const Def* Global ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.global(ops[0], is_mutable(), debug()); }
 const Def* Hlt    ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.hlt(ops[0], debug()); }
@@ -186,19 +198,26 @@ const Def* Known  ::vrebuild(World& to, Defs ops, const Type*  ) const { return
 const Def* Run    ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.run(ops[0], debug()); }
 const Def* Insert ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.insert(ops[0], ops[1], ops[2], debug()); }
 const Def* LEA    ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.lea(ops[0], ops[1], debug()); }
-const Def* Load   ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.load(ops[0], ops[1], debug()); }
+const Def* Load   ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.load(ops[0], ops[1], debug(), flags()); }
 const Def* PrimLit::vrebuild(World& to, Defs,     const Type*  ) const { return to.literal(primtype_tag(), value(), debug()); }
 const Def* Select ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.select(ops[0], ops[1], ops[2], debug()); }
 const Def* SizeOf ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.size_of(ops[0]->type(), debug()); }
 const Def* Slot   ::vrebuild(World& to, Defs ops, const Type* t) const { return to.slot(t->as<PtrType>()->pointee(), ops[0], debug()); }
-const Def* Store  ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.store(ops[0], ops[1], ops[2], debug()); }
+const Def* Store  ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.store(ops[0], ops[1], ops[2], debug(), flags()); }
 const Def* Tuple  ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.tuple(ops, debug()); }
 const Def* Closure::vrebuild(World& to, Defs ops, const Type* t) const { return to.closure(t->as<ClosureType>(), ops[0], ops[1], debug()); }
 const Def* Variant::vrebuild(World& to, Defs ops, const Type* t) const { return to.variant(t->as<VariantType>(), ops[0], debug()); }
 const Def* Vector ::vrebuild(World& to, Defs ops, const Type*  ) const { return to.vector(ops, debug()); }
 
 const Def* Alloc::vrebuild(World& to, Defs ops, const Type* t) const {
-    return to.alloc(t->as<TupleType>()->op(1)->as<PtrType>()->pointee(), ops[0], ops[1], debug());
+    auto type = t->as<TupleType>()->op(1)->as<PtrType>()->pointee();
+    if (ops.size() == 3)
+        return to.region_alloc(type, ops[0], ops[1], ops[2], debug());
+    return to.alloc(type, ops[0], ops[1], debug());
+}
+
+const Def* Prefetch::vrebuild(World& to, Defs ops, const Type*) const {
+    return to.prefetch(ops[0], ops[1], is_write(), locality(), debug());
 }
 
 const Def* Assembly::vrebuild(World& to, Defs ops, const Type* t) const {
@@ -142,6 +142,55 @@ public:
     friend class World;
 };
 
+/**
+ * Evaluates to @p value but tells the backends that @p value most likely equals the literal @p expected.
+ * A @p Branch or @p Match on an @p Expect is weighted accordingly.
+ */
+class Expect : public PrimOp {
+private:
+    Expect(const Def* value, const Def* expected, Debug dbg)
+        : PrimOp(Node_Expect, value->type(), {value, expected}, dbg)
+    {
+        assert(expected->isa<PrimLit>() && value->type() == expected->type());
+    }
+
+    virtual const Def* vrebuild(World& to, Defs ops, const Type* type) const override;
+
+public:
+    const Def* value() const { return op(0); }
+    const PrimLit* expected() const { return op(1)->as<PrimLit>(); }
+
+    friend class World;
+};
+
+/**
+ * Evaluates to the pointer @p ptr but tells the backends that its address is a multiple of @p align bytes.
+ * Pointers derived from it via @p LEA inherit as much of this alignment as their offset allows.
+ */
+class Aligned : public PrimOp {
+private:
+    Aligned(const Def* ptr, u32 align, Debug dbg)
+        : PrimOp(Node_Aligned, ptr->type(), {ptr}, dbg)
+        , align_(align)
+    {
+        assert(ptr->type()->isa<PtrType>() && is_power_of_2(align));
+    }
+
+    virtual uint64_t vhash() const override;
+    virtual bool equal(const PrimOp* other) const override;
+    virtual const Def* vrebuild(World& to, Defs ops, const Type* type) const override;
+
+public:
+    const Def* ptr() const { return op(0); }
+    const PtrType* type() const { return PrimOp::type()->as<PtrType>(); }
+    u32 align() const { return align_; }
+
+private:
+    u32 align_;
+
+    friend class World;
+};
+
 /// Get number of bytes needed for any value (including bottom) of a given @p Type.
 class SizeOf : public PrimOp {
 private:
@@ -171,21 +220,63 @@ public:
 
 /// One of \p ArithOpTag arithmetic operation.
 class ArithOp : public BinOp {
+public:
+    /**
+     * Facts about the operation the backends may exploit - see LLVM's flags of the same names.
+     * The first three only apply to integer operations, the fast-math flags only to floating point ones.
+     */
+    enum Flags {
+        NoFlag   = 0,
+        NSW      = 1 << 0, ///< Signed overflow does not occur.
+        NUW      = 1 << 1, ///< Unsigned overflow does not occur.
+        Exact    = 1 << 2, ///< A @c div or @c shr does not drop any non-zero bits.
+        Reassoc  = 1 << 3, ///< The operation may be reassociated.
+        Contract = 1 << 4, ///< The operation may be fused with others - e.g. to an FMA.
+        NNaN     = 1 << 5, ///< Neither operands nor result are NaN.
+        NInf     = 1 << 6, ///< Neither operands nor result are infinite.
+        NSZ      = 1 << 7, ///< The sign of a zero is insignificant.
+        ARcp     = 1 << 8, ///< A division may use the reciprocal of its divisor.
+        IntFlags = NSW | NUW | Exact,
+        Fast     = Reassoc | Contract | NNaN | NInf | NSZ | ARcp,
+    };
+
 private:
-    ArithOp(ArithOpTag tag, const Def* lhs, const Def* rhs, Debug dbg)
+    ArithOp(ArithOpTag tag, const Def* lhs, const Def* rhs, Flags flags, Debug dbg)
         : BinOp((NodeTag) tag, lhs->type(), lhs, rhs, dbg)
+        , flags_(flags)
     {}
 
+    virtual uint64_t vhash() const override;
+    virtual bool equal(const PrimOp* other) const override;
     virtual const Def* vrebuild(World& to, Defs ops, const Type* type) const override;
 
 public:
     const PrimType* type() const { return BinOp::type()->as<PrimType>(); }
     ArithOpTag arithop_tag() const { return (ArithOpTag) tag(); }
+    Flags flags() const { return flags_; }
+    bool is_nsw() const { return flags_ & NSW; }
+    bool is_nuw() const { return flags_ & NUW; }
+    bool is_exact() const { return flags_ & Exact; }
+    Flags fast_math_flags() const { return Flags(flags_ & Fast); }
+    bool is_reassoc() const { return flags_ & Reassoc; }
+    bool is_contract() const { return flags_ & Contract; }
+    bool is_nnan() const { return flags_ & NNaN; }
+    bool is_ninf() const { return flags_ & NInf; }
+    bool is_nsz() const { return flags_ & NSZ; }
+    bool is_arcp() const { return flags_ & ARcp; }
     virtual const char* op_name() const override;
 
+private:
+    Flags flags_;
+
     friend class World;
 };
 
+inline ArithOp::Flags operator|(ArithOp::Flags lhs, ArithOp::Flags rhs) { return static_cast<ArithOp::Flags>(static_cast<int>(lhs) | static_cast<int>(rhs)); }
+inline ArithOp::Flags operator&(ArithOp::Flags lhs, ArithOp::Flags rhs) { return static_cast<ArithOp::Flags>(static_cast<int>(lhs) & static_cast<int>(rhs)); }
+inline ArithOp::Flags operator|=(ArithOp::Flags& lhs, ArithOp::Flags rhs) { return lhs = lhs | rhs; }
+inline ArithOp::Flags operator&=(ArithOp::Flags& lhs, ArithOp::Flags rhs) { return lhs = lhs & rhs; }
+
 /// One of \p CmpTag compare.
 class Cmp : public BinOp {
 private:
@@ -540,13 +631,18 @@ private:
     virtual bool equal(const PrimOp* other) const override { return this == other; }
 };
 
-/// Allocates memory on the heap.
+/**
+ * Allocates memory on the heap.
+ * If tagged with a @p region, the memory is bump-allocated from that region and released in bulk once it is left.
+ * @see Intrinsic::EnterRegion, Intrinsic::LeaveRegion
+ */
 class Alloc : public MemOp {
 private:
-    Alloc(const Type* type, const Def* mem, const Def* extra, Debug dbg);
+    Alloc(const Type* type, const Def* mem, const Def* extra, const Def* region, Debug dbg);
 
 public:
     const Def* extra() const { return op(1); }
+    const Def* region() const { return num_ops() == 3 ? op(2) : nullptr; }
     virtual bool has_multiple_outs() const override { return true; }
     const Def* out_ptr() const { return out(1); }
     const TupleType* type() const { return MemOp::type()->as<TupleType>(); }
@@ -563,21 +659,33 @@ private:
 
 /// Base class for @p Load and @p Store.
 class Access : public MemOp {
+public:
+    enum Flags {
+        NoFlag      = 0,
+        NonTemporal = 1 << 0, ///< The data is not going to be reused soon and should not pollute the caches - see LLVM's !nontemporal.
+    };
+
 protected:
-    Access(NodeTag tag, const Type* type, Defs args, Debug dbg)
+    Access(NodeTag tag, const Type* type, Defs args, Flags flags, Debug dbg)
         : MemOp(tag, type, args, dbg)
+        , flags_(flags)
     {
         assert(args.size() >= 2);
     }
 
 public:
     const Def* ptr() const { return op(1); }
+    Flags flags() const { return flags_; }
+    bool is_nontemporal() const { return flags_ & NonTemporal; }
+
+private:
+    Flags flags_;
 };
 
 /// Loads with current effect <tt>mem</tt> from <tt>ptr</tt> to produce a pair of a new effect and the loaded value.
 class Load : public Access {
 private:
-    Load(const Def* mem, const Def* ptr, Debug dbg);
+    Load(const Def* mem, const Def* ptr, Flags flags, Debug dbg);
 
 public:
     virtual bool has_multiple_outs() const override { return true; }
@@ -596,8 +704,8 @@ private:
 /// Stores with current effect <tt>mem</tt> <tt>value</tt> into <tt>ptr</tt> while producing a new effect.
 class Store : public Access {
 private:
-    Store(const Def* mem, const Def* ptr, const Def* value, Debug dbg)
-        : Access(Node_Store, mem->type(), {mem, ptr, value}, dbg)
+    Store(const Def* mem, const Def* ptr, const Def* value, Flags flags, Debug dbg)
+        : Access(Node_Store, mem->type(), {mem, ptr, value}, flags, dbg)
     {}
 
     virtual const Def* vrebuild(World& to, Defs ops, const Type* type) const override;
@@ -609,6 +717,36 @@ public:
     friend class World;
 };
 
+/**
+ * Hints with current effect <tt>mem</tt> that <tt>ptr</tt> is going to be accessed soon while producing a new effect.
+ * Prefetching never faults; thus, <tt>ptr</tt> may point anywhere.
+ * @p locality ranges from @c 0 (no temporal locality) to @c 3 (keep in all caches) - see LLVM's @c llvm.prefetch.
+ */
+class Prefetch : public MemOp {
+private:
+    Prefetch(const Def* mem, const Def* ptr, bool write, int locality, Debug dbg)
+        : MemOp(Node_Prefetch, mem->type(), {mem, ptr}, dbg)
+        , write_(write)
+        , locality_(locality)
+    {
+        assert(0 <= locality && locality <= 3);
+    }
+
+    virtual const Def* vrebuild(World& to, Defs ops, const Type* type) const override;
+
+public:
+    const Def* ptr() const { return op(1); }
+    const MemType* type() const { return MemOp::type()->as<MemType>(); }
+    bool is_write() const { return write_; }
+    int locality() const { return locality_; }
+
+private:
+    bool write_;
+    int locality_;
+
+    friend class World;
+};
+
 /// Creates a stack \p Frame with current effect <tt>mem</tt>.
 class Enter : public MemOp {
 private:
@@ -0,0 +1,74 @@
+#include "thorin/profile.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace thorin {
+
+void Profile::clear() {
+    key2count_.clear();
+    max_count_ = 0;
+}
+
+Symbol Profile::key(const Continuation* continuation) {
+    const auto& loc = continuation->location();
+    if (!loc.is_set())
+        return Symbol();
+
+    std::ostringstream oss;
+    oss << (continuation->name().empty() ? "_" : continuation->name().c_str()) << '@' << loc.filename() << ':'
+        << loc.front_line() << ':' << loc.front_col() << ':' << loc.back_line() << ':' << loc.back_col();
+    return oss.str();
+}
+
+void Profile::add(Symbol key, u64 count) {
+    assert(!key.empty());
+    auto& entry = key2count_[key];
+    entry += count;
+    max_count_ = std::max(max_count_, entry);
+}
+
+bool Profile::lookup(const Continuation* continuation, u64& count) const {
+    auto k = key(continuation);
+    if (k.empty())
+        return false;
+
+    auto i = key2count_.find(k);
+    if (i == key2count_.end())
+        return false;
+
+    count = i->second;
+    return true;
+}
+
+double Profile::hotness(const Continuation* continuation, double otherwise) const {
+    u64 count;
+    if (max_count_ == 0 || !lookup(continuation, count))
+        return otherwise;
+    return double(count) / double(max_count_);
+}
+
+bool Profile::read(std::istream& is) {
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.empty())
+            continue;
+
+        // the key may contain spaces: it is the rest of the line
+        std::istringstream iss(line);
+        u64 count;
+        std::string key;
+        if (!(iss >> count) || iss.get() != ' ' || !std::getline(iss, key) || key.empty())
+            return false;
+        add(key, count);
+    }
+
+    return true;
+}
+
+void Profile::write(std::ostream& os) const {
+    for (const auto& p : key2count_)
+        os << p.second << ' ' << p.first << std::endl;
+}
+
+}
@@ -0,0 +1,52 @@
+#ifndef THORIN_PROFILE_H
+#define THORIN_PROFILE_H
+
+#include <iostream>
+#include <string>
+
+#include "thorin/continuation.h"
+#include "thorin/util/symbol.h"
+
+namespace thorin {
+
+/**
+ * Execution counts of @p Continuation%s gathered by an instrumented build (see @p CodeGen::emit).
+ * Counts are keyed by the location and name of a @p Continuation as these - unlike gids - survive optimizations and
+ * stay the same from one compilation to the next.
+ * Copies of a continuation - e.g., from unrolling or specialization - share its key and their counts add up.
+ * Continuations without a location have no key and, thus, no count.
+ */
+class Profile {
+public:
+    bool empty() const { return key2count_.empty(); }
+    void clear();
+    /// The key of @p continuation or the empty @p Symbol if it has no location.
+    static Symbol key(const Continuation* continuation);
+    void add(Symbol key, u64 count);
+    /// Returns @c true and sets @p count if a count for @p continuation is known.
+    bool lookup(const Continuation* continuation, u64& count) const;
+    u64 max_count() const { return max_count_; }
+    /**
+     * Returns the count of @p continuation relative to @p max_count in [0, 1].
+     * Unknown continuations yield @p otherwise.
+     */
+    double hotness(const Continuation* continuation, double otherwise = 0.5) const;
+
+    /// Reads lines of the form "count key" as written by instrumented code; returns @c false on a malformed line.
+    bool read(std::istream&);
+    void write(std::ostream&) const;
+
+    friend void swap(Profile& p1, Profile& p2) {
+        using std::swap;
+        swap(p1.key2count_, p2.key2count_);
+        swap(p1.max_count_, p2.max_count_);
+    }
+
+private:
+    HashMap<Symbol, u64> key2count_;
+    u64 max_count_ = 0;
+};
+
+}
+
+#endif
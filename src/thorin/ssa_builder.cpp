@@ -0,0 +1,257 @@
+#include "thorin/ssa_builder.h"
+
+#include "thorin/world.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+SSABuilder::Block& SSABuilder::block(Continuation* bb) {
+    auto p = bb2index_.emplace(bb, blocks_.size());
+    if (p.second)
+        blocks_.emplace_back(bb);
+    return blocks_[p.first->second];
+}
+
+const SSABuilder::Block* SSABuilder::find_block(const Continuation* bb) const {
+    auto i = bb2index_.find(const_cast<Continuation*>(bb));
+    return i == bb2index_.end() ? nullptr : &blocks_[i->second];
+}
+
+Continuation* SSABuilder::parent(const Continuation* bb) const {
+    if (auto block = find_block(bb))
+        return block->parent;
+    return const_cast<Continuation*>(bb);
+}
+
+bool SSABuilder::is_sealed(const Continuation* bb) const {
+    if (auto block = find_block(bb))
+        return block->is_sealed;
+    return true;
+}
+
+bool SSABuilder::is_cleared(const Continuation* bb) const {
+    if (auto block = find_block(bb))
+        return block->values.empty();
+    return true;
+}
+
+void SSABuilder::clear_values(Continuation* bb) {
+    if (bb2index_.contains(bb))
+        block(bb).values.clear();
+}
+
+void SSABuilder::clear_values() {
+    for (auto& block : blocks_)
+        block.values.clear();
+}
+
+void SSABuilder::clear() {
+    bb2index_.clear();
+    blocks_.clear();
+}
+
+const Continuations& SSABuilder::preds(Block& block) {
+    assert(block.is_sealed);
+    if (!block.has_preds) {
+        block.preds = block.continuation->preds();
+        block.has_preds = true;
+    }
+    return block.preds;
+}
+
+void SSABuilder::unseal(Continuation* bb) {
+    auto& block = this->block(bb);
+    block.is_sealed = false;
+    block.has_preds = false;
+    block.preds.clear();
+}
+
+void SSABuilder::seal(Continuation* bb) {
+    auto& block = this->block(bb);
+    assert(!block.is_sealed && "already sealed");
+    block.is_sealed = true;
+
+    auto todos = std::move(block.todos);
+    block.todos.clear();
+    for (const auto& todo : todos)
+        fix(block, todo.handle(), todo.index(), todo.type(), todo.debug());
+}
+
+/*
+ * value numbering
+ */
+
+const Def* SSABuilder::set_value(Block& block, size_t handle, const Def* def) {
+    if (handle >= block.values.size())
+        block.values.resize(handle+1);
+    return block.values[handle] = def;
+}
+
+const Def* SSABuilder::find_def(Block& block, size_t handle) {
+    return handle < block.values.size() ? block.values[handle].def() : nullptr;
+}
+
+const Def* SSABuilder::get_mem(Continuation* bb) { return get_value(bb, 0, bb->world().mem_type(), { "mem" }); }
+
+const Def* SSABuilder::get_bottom(Block& block, size_t handle, const Type* type, Debug dbg) {
+    WLOG(&dbg, "'{}' may be undefined", dbg.name());
+    return set_value(block, handle, block.continuation->world().bottom(type));
+}
+
+const Def* SSABuilder::get_value(Continuation* bb, size_t handle, const Type* type, Debug dbg) {
+    // walk up function heads and chains of single predecessors without recursion;
+    // only joins recurse into their predecessors
+    std::vector<Block*> chain;
+    const Def* result = nullptr;
+    auto mark = ++mark_;
+
+    for (auto cur = &block(bb); !result;) {
+        if ((result = find_def(*cur, handle)))
+            break;
+
+        if (cur->parent != cur->continuation) { // is a function head?
+            if (cur->parent)
+                cur = &block(cur->parent);
+            else
+                result = get_bottom(*cur, handle, type, dbg);
+            continue;
+        }
+
+        if (!cur->is_sealed) {
+            auto param = cur->continuation->append_param(type, dbg);
+            cur->todos.emplace_back(handle, param->index(), type, dbg);
+            result = set_value(*cur, handle, param);
+            continue;
+        }
+
+        if (cur->mark == mark) { // a cycle of single predecessors is unreachable
+            result = get_bottom(*cur, handle, type, dbg);
+            continue;
+        }
+        cur->mark = mark;
+
+        const auto& preds = this->preds(*cur);
+        switch (preds.size()) {
+            case 0:
+                result = get_bottom(*cur, handle, type, dbg);
+                break;
+            case 1:
+                chain.emplace_back(cur);
+                cur = &block(preds.front());
+                break;
+            default:
+                result = get_value_join(*cur, handle, type, dbg);
+                break;
+        }
+    }
+
+    for (auto block : chain)
+        set_value(*block, handle, result);
+
+    assert(result->type() == type);
+    return result;
+}
+
+const Def* SSABuilder::get_value_join(Block& block, size_t handle, const Type* type, Debug dbg) {
+    auto bb = block.continuation;
+    if (block.is_visited)
+        return set_value(block, handle, bb->append_param(type, dbg)); // create param to break cycle
+
+    block.is_visited = true;
+    const Def* same = nullptr;
+    for (auto pred : preds(block)) {
+        auto def = get_value(pred, handle, type, dbg);
+        if (same && same != def) {
+            same = (const Def*)-1; // defs from preds are different
+            break;
+        }
+        same = def;
+    }
+    assert(same != nullptr);
+    block.is_visited = false;
+
+    // fix any params which may have been introduced to break the cycle above
+    const Def* def = nullptr;
+    if (auto found = find_def(block, handle))
+        def = fix(block, handle, found->as<Param>()->index(), type, dbg);
+
+    if (same != (const Def*)-1)
+        return same;
+
+    if (def)
+        return set_value(block, handle, def);
+
+    auto param = bb->append_param(type, dbg);
+    set_value(block, handle, param);
+    fix(block, handle, param->index(), type, dbg);
+    return param;
+}
+
+const Def* SSABuilder::fix(Block& block, size_t handle, size_t index, const Type* type, Debug dbg) {
+    auto param = block.continuation->param(index);
+
+    assert(block.is_sealed && "must be sealed");
+    assert(index == param->index());
+
+    for (auto pred : preds(block)) {
+        assert(!pred->empty());
+        //assert(pred->direct_succs().size() == 1 && "critical edge");
+        auto def = get_value(pred, handle, type, dbg);
+
+        // make potentially room for the new arg
+        if (index >= pred->num_args())
+            pred->resize(index+2);
+
+        assert(!pred->arg(index) && "already set");
+        pred->set_op(index + 1, def);
+    }
+
+    return try_remove_trivial_param(param);
+}
+
+const Def* SSABuilder::try_remove_trivial_param(const Param* param) {
+    auto bb = param->continuation();
+    auto& block = this->block(bb);
+    assert(block.is_sealed && "must be sealed");
+
+    size_t index = param->index();
+
+    // find Horspool-like phis
+    const Def* same = nullptr;
+    for (auto pred : preds(block)) {
+        auto def = pred->arg(index);
+        if (def == param || same == def)
+            continue;
+        if (same)
+            return param;
+        same = def;
+    }
+    assert(same != nullptr);
+    param->replace(same);
+
+    for (auto peek : param->peek()) {
+        auto continuation = peek.from();
+        continuation->unset_op(index+1);
+        continuation->set_op(index+1, bb->world().bottom(param->type(), param->debug()));
+    }
+
+    for (auto use : same->uses()) {
+        if (Continuation* continuation = use->isa_continuation()) {
+            for (auto succ : continuation->succs()) {
+                size_t index = -1;
+                for (size_t i = 0, e = succ->num_args(); i != e; ++i) {
+                    if (succ->arg(i) == use.def()) {
+                        index = i;
+                        break;
+                    }
+                }
+                if (index != size_t(-1) && param != succ->param(index))
+                    try_remove_trivial_param(succ->param(index));
+            }
+        }
+    }
+
+    return same;
+}
+
+}
@@ -0,0 +1,115 @@
+#ifndef THORIN_SSA_BUILDER_H
+#define THORIN_SSA_BUILDER_H
+
+#include <deque>
+#include <vector>
+
+#include "thorin/continuation.h"
+
+namespace thorin {
+
+/**
+ * On-the-fly SSA construction as described by Braun et al.
+ * All value numbering tables live here instead of in the individual @p Continuation%s:
+ * Each block gets a dense row of values indexed by handle, a list of pending params and a cached list of its predecessors.
+ * A @p World owns one @p SSABuilder which serves the value numbering interface of @p Continuation (used by @p IRBuilder);
+ * passes like @p mem2reg use their own @p SSABuilder per @p Scope.
+ */
+class SSABuilder {
+public:
+    SSABuilder() {}
+    SSABuilder(const SSABuilder&) = delete;
+    SSABuilder& operator=(const SSABuilder&) = delete;
+
+    /// See @p Block::parent for more information.
+    Continuation* parent(const Continuation*) const;
+    void set_parent(Continuation* bb, Continuation* parent) { block(bb).parent = parent; }
+    bool is_sealed(const Continuation*) const;
+    void seal(Continuation*);
+    void unseal(Continuation*);
+
+    const Def* set_value(Continuation* bb, size_t handle, const Def* def) { return set_value(block(bb), handle, def); }
+    const Def* get_value(Continuation* bb, size_t handle, const Type* type, Debug dbg = {});
+    const Def* set_mem(Continuation* bb, const Def* def) { return set_value(bb, 0, def); }
+    const Def* get_mem(Continuation* bb);
+
+    bool is_cleared(const Continuation*) const;
+    void clear_values(Continuation*);
+    void clear_values();  ///< Clears the values of all blocks but retains their parents and seal states.
+    void clear();         ///< Forgets everything.
+
+    friend void swap(SSABuilder& b1, SSABuilder& b2) {
+        using std::swap;
+        swap(b1.bb2index_, b2.bb2index_);
+        swap(b1.blocks_,   b2.blocks_);
+        swap(b1.mark_,     b2.mark_);
+    }
+
+private:
+    class Todo {
+    public:
+        Todo() {}
+        Todo(size_t handle, size_t index, const Type* type, Debug dbg)
+            : handle_(handle)
+            , index_(index)
+            , type_(type)
+            , debug_(dbg)
+        {}
+
+        size_t handle() const { return handle_; }
+        size_t index() const { return index_; }
+        const Type* type() const { return type_; }
+        Debug debug() const { return debug_; }
+
+    private:
+        size_t handle_;
+        size_t index_;
+        const Type* type_;
+        Debug debug_;
+    };
+
+    struct Block {
+        Block(Continuation* continuation)
+            : continuation(continuation)
+            , parent(continuation)
+        {}
+
+        Continuation* continuation;
+        /**
+         * There exist three cases to distinguish here.
+         * - @p parent == @p continuation: This block is considered as a basic block, i.e.,
+         *                                 SSA construction will propagate value through this block's predecessors.
+         * - @p parent == nullptr: This block is considered as top level function, i.e.,
+         *                         SSA construction will stop propagate values here.
+         *                         Any @p get_value which arrives here without finding a definition will return @p bottom.
+         * - otherwise: This block is considered as function head nested in @p parent.
+         *              Any @p get_value which arrives here without finding a definition will try to find one in @p parent.
+         */
+        Continuation* parent;
+        std::vector<Tracker> values;
+        std::vector<Todo> todos;
+        Continuations preds;    ///< Cached once the block is sealed - a sealed block does not get any new predecessors.
+        uint32_t mark = 0;      ///< Blocks on the current chain of single predecessors carry the current @p mark_.
+        bool is_sealed  = true;
+        bool has_preds  = false;
+        bool is_visited = false;
+    };
+
+    Block& block(Continuation*);
+    const Block* find_block(const Continuation*) const;
+    const Continuations& preds(Block&);
+    const Def* set_value(Block&, size_t handle, const Def* def);
+    const Def* find_def(Block&, size_t handle);
+    const Def* get_bottom(Block&, size_t handle, const Type* type, Debug dbg);
+    const Def* get_value_join(Block&, size_t handle, const Type* type, Debug dbg);
+    const Def* fix(Block&, size_t handle, size_t index, const Type* type, Debug dbg);
+    const Def* try_remove_trivial_param(const Param*);
+
+    ContinuationMap<size_t> bb2index_;
+    std::deque<Block> blocks_; ///< A @p std::deque keeps references to @p Block%s stable while new ones are added.
+    uint32_t mark_ = 0;
+};
+
+}
+
+#endif
@@ -16,7 +16,10 @@
                 THORIN_NODE(Store, store)
             THORIN_NODE(Enter, enter)
             THORIN_NODE(Leave, leave)
+            THORIN_NODE(Prefetch, prefetch)
         THORIN_NODE(Select, select)
+        THORIN_NODE(Expect, expect)
+        THORIN_NODE(Aligned, aligned)
         THORIN_NODE(SizeOf, size_of)
         THORIN_NODE(Global, global)
         THORIN_NODE(Slot, slot)
@@ -0,0 +1,38 @@
+#include "thorin/transform/annotate_arithops.h"
+
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/range.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+void annotate_arithops(World& world) {
+    size_t num_annotated = 0;
+
+    Scope::for_each(world, [&] (const Scope& scope) {
+        RangeAnalysis ranges(scope);
+
+        std::vector<std::pair<const ArithOp*, ArithOp::Flags>> todo;
+        for (auto def : scope.defs()) {
+            if (auto arithop = def->isa<ArithOp>()) {
+                auto flags = arithop->flags() | ranges.flags(arithop);
+                if (flags != arithop->flags())
+                    todo.emplace_back(arithop, flags);
+            }
+        }
+
+        // operands which have been replaced before are already rewired to their annotated versions
+        for (const auto& p : todo) {
+            auto arithop = p.first;
+            DLOG("annotating {} with flags {}", arithop, int(p.second));
+            arithop->replace(world.arithop(arithop->arithop_tag(), arithop->lhs(), arithop->rhs(), arithop->debug(), p.second));
+        }
+        num_annotated += todo.size();
+    });
+
+    VLOG("annotate arithops: {} arithops annotated", num_annotated);
+}
+
+}
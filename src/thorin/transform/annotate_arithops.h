@@ -0,0 +1,13 @@
+#ifndef THORIN_TRANSFORM_ANNOTATE_ARITHOPS_H
+#define THORIN_TRANSFORM_ANNOTATE_ARITHOPS_H
+
+namespace thorin {
+
+class World;
+
+/// Adds the @p ArithOp::Flags to each @p ArithOp which the @p RangeAnalysis of its @p Scope proves.
+void annotate_arithops(World&);
+
+}
+
+#endif
@@ -33,66 +33,100 @@ private:
 };
 
 void Cleaner::eta_conversion() {
-    for (bool todo = true; todo;) {
-        todo = false;
-        for (auto continuation : world().continuations()) {
-            if (!continuation->empty()) {
-                // eat calls to known continuations that are only used once
-                while (auto callee = continuation->callee()->isa_continuation()) {
-                    if (callee->num_uses() == 1 && !callee->empty() && !callee->is_external()) {
-                        for (size_t i = 0, e = continuation->num_args(); i != e; ++i)
-                            callee->param(i)->replace(continuation->arg(i));
-                        continuation->jump(callee->callee(), callee->args(), callee->jump_debug());
-                        callee->destroy_body();
-                        todo_ = todo = true;
-                    } else
-                        break;
-                }
+    std::queue<Continuation*> queue;
+    ContinuationSet queued;
+    auto enqueue = [&](Continuation* continuation) {
+        if (queued.emplace(continuation).second)
+            queue.push(continuation);
+    };
+    auto enqueue_users = [&](const Def* def) {
+        for (auto use : def->uses()) {
+            if (auto ucontinuation = use->isa_continuation())
+                enqueue(ucontinuation);
+        }
+    };
+    // a changed jump alters the number of uses of the continuations it used to refer to
+    // which may enable further conversions in their remaining users
+    auto enqueue_ops = [&](Defs ops) {
+        for (auto op : ops) {
+            if (auto continuation = op->isa_continuation())
+                enqueue_users(continuation);
+        }
+    };
 
-                // try to subsume continuations which call a parameter
-                // (that is free within that continuation) with that parameter
-                if (auto param = continuation->callee()->isa<Param>()) {
-                    if (param->continuation() == continuation || continuation->is_external())
-                        continue;
-
-                    if (continuation->args() == continuation->params_as_defs()) {
-                        continuation->replace(continuation->callee());
-                        continuation->destroy_body();
-                        todo_ = todo = true;
-                        continue;
-                    }
+    for (auto continuation : world().continuations())
+        enqueue(continuation);
 
-                    // build the permutation of the arguments
-                    Array<size_t> perm(continuation->num_args());
-                    bool is_permutation = true;
-                    for (size_t i = 0, e = continuation->num_args(); i != e; ++i)  {
-                        auto param_it = std::find(continuation->params().begin(),
-                                                    continuation->params().end(),
-                                                    continuation->arg(i));
+    while (!queue.empty()) {
+        auto continuation = pop(queue);
+        queued.erase(continuation);
+
+        if (continuation->empty())
+            continue;
+
+        // eat calls to known continuations that are only used once
+        while (auto callee = continuation->callee()->isa_continuation()) {
+            if (callee->num_uses() == 1 && !callee->empty() && !callee->is_external()) {
+                Array<const Def*> old_ops(continuation->ops());
+                for (auto param : callee->params())
+                    enqueue_users(param);
+                replace_all(callee->params_as_defs(), old_ops.skip_front());
+                continuation->jump(callee->callee(), callee->args(), callee->jump_debug());
+                callee->destroy_body();
+                enqueue_ops(old_ops);
+                todo_ = true;
+            } else
+                break;
+        }
 
-                        if (param_it == continuation->params().end()) {
-                            is_permutation = false;
-                            break;
-                        }
+        // try to subsume continuations which call a parameter
+        // (that is free within that continuation) with that parameter
+        if (auto param = continuation->callee()->isa<Param>()) {
+            if (param->continuation() == continuation || continuation->is_external())
+                continue;
 
-                        perm[i] = param_it - continuation->params().begin();
-                    }
+            if (continuation->args() == continuation->params_as_defs()) {
+                Array<const Def*> old_ops(continuation->ops());
+                enqueue_users(continuation);
+                continuation->replace(continuation->callee());
+                continuation->destroy_body();
+                enqueue_ops(old_ops);
+                todo_ = true;
+                continue;
+            }
+
+            // build the permutation of the arguments
+            Array<size_t> perm(continuation->num_args());
+            bool is_permutation = true;
+            for (size_t i = 0, e = continuation->num_args(); i != e; ++i)  {
+                auto param_it = std::find(continuation->params().begin(),
+                                            continuation->params().end(),
+                                            continuation->arg(i));
+
+                if (param_it == continuation->params().end()) {
+                    is_permutation = false;
+                    break;
+                }
+
+                perm[i] = param_it - continuation->params().begin();
+            }
 
-                    if (!is_permutation) continue;
-
-                    // for every use of the continuation at a call site,
-                    // permute the arguments and call the parameter instead
-                    for (auto use : continuation->copy_uses()) {
-                        auto ucontinuation = use->isa_continuation();
-                        if (ucontinuation && use.index() == 0) {
-                            Array<const Def*> new_args(perm.size());
-                            for (size_t i = 0, e = perm.size(); i != e; ++i) {
-                                new_args[i] = ucontinuation->arg(perm[i]);
-                            }
-                            ucontinuation->jump(param, new_args, ucontinuation->jump_debug());
-                            todo_ = todo = true;
-                        }
+            if (!is_permutation) continue;
+
+            // for every use of the continuation at a call site,
+            // permute the arguments and call the parameter instead
+            for (auto use : continuation->copy_uses()) {
+                auto ucontinuation = use->isa_continuation();
+                if (ucontinuation && use.index() == 0) {
+                    Array<const Def*> old_ops(ucontinuation->ops());
+                    Array<const Def*> new_args(perm.size());
+                    for (size_t i = 0, e = perm.size(); i != e; ++i) {
+                        new_args[i] = ucontinuation->arg(perm[i]);
                     }
+                    ucontinuation->jump(param, new_args, ucontinuation->jump_debug());
+                    enqueue(ucontinuation);
+                    enqueue_ops(old_ops);
+                    todo_ = true;
                 }
             }
         }
@@ -100,7 +134,19 @@ void Cleaner::eta_conversion() {
 }
 
 void Cleaner::eliminate_params() {
-    for (auto ocontinuation : world().copy_continuations()) {
+    std::queue<Continuation*> queue;
+    ContinuationSet queued;
+    auto enqueue = [&](Continuation* continuation) {
+        if (queued.emplace(continuation).second)
+            queue.push(continuation);
+    };
+
+    for (auto continuation : world().continuations())
+        enqueue(continuation);
+
+    while (!queue.empty()) {
+        auto ocontinuation = pop(queue);
+        queued.erase(ocontinuation);
         std::vector<size_t> proxy_idx;
         std::vector<size_t> param_idx;
 
@@ -121,11 +167,13 @@ void Cleaner::eliminate_params() {
             if (!proxy_idx.empty()) {
                 auto ncontinuation = world().continuation(world().fn_type(ocontinuation->type()->ops().cut(proxy_idx)),
                                             ocontinuation->cc(), ocontinuation->intrinsic(), ocontinuation->debug_history());
+                Array<const Def*> oparams(param_idx.size());
                 size_t j = 0;
                 for (auto i : param_idx) {
-                    ocontinuation->param(i)->replace(ncontinuation->param(j));
+                    oparams[j] = ocontinuation->param(i);
                     ncontinuation->param(j++)->debug() = ocontinuation->param(i)->debug_history();
                 }
+                replace_all(oparams, ncontinuation->params_as_defs());
 
                 if (!ocontinuation->filter().empty())
                     ncontinuation->set_filter(ocontinuation->filter().cut(proxy_idx));
@@ -135,7 +183,14 @@ void Cleaner::eliminate_params() {
                 for (auto use : ocontinuation->copy_uses()) {
                     auto ucontinuation = use->as_continuation();
                     assert(use.index() == 0);
+                    Array<const Def*> dropped(proxy_idx.size(), [&](size_t i) { return ucontinuation->arg(proxy_idx[i]); });
                     ucontinuation->jump(ncontinuation, ucontinuation->args().cut(proxy_idx), ucontinuation->jump_debug());
+
+                    // dropping these args may leave params of the caller unused
+                    for (auto arg : dropped) {
+                        if (auto param = arg->isa<Param>())
+                            enqueue(param->continuation());
+                    }
                 }
 
                 todo_ = true;
@@ -149,6 +204,8 @@ void Cleaner::rebuild() {
     Importer importer(world_);
     importer.type_old2new_.rehash(world_.types_.capacity());
     importer.def_old2new_.rehash(world_.primops().capacity());
+    importer.world().reserve(world_.primops().size(), world_.types().size());
+    swap(importer.world().profile(), world_.profile());
 
 #if THORIN_ENABLE_CHECKS
     world_.swap_breakpoints(importer.world());
@@ -0,0 +1,233 @@
+#include "thorin/transform/color_slots.h"
+
+#include <algorithm>
+
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/analyses/verify.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+class SlotColoring {
+public:
+    SlotColoring(const Scope& scope)
+        : scope_(scope)
+        , schedule_(scope)
+    {}
+
+    size_t run() {
+        for (const auto& block : schedule_) {
+            for (auto primop : block) {
+                if (auto slot = primop->isa<Slot>())
+                    collect(slot);
+            }
+        }
+
+        if (slots_.size() < 2)
+            return 0;
+
+        std::fill(written_out_.array().begin(), written_out_.array().end(), none());
+        std::fill(live_in_.array().begin(), live_in_.array().end(), none());
+
+        for (const auto& block : schedule_) {
+            for (auto primop : block) {
+                auto i = memop2access_.find(primop);
+                if (i != memop2access_.end())
+                    events_[block].push_back(i->second);
+            }
+        }
+
+        compute_written();
+        compute_live();
+        compute_interference();
+        return merge();
+    }
+
+private:
+    enum Access {
+        Read,
+        Write, ///< Writes a part of the slot.
+        Kill,  ///< Overwrites the whole slot.
+    };
+    typedef std::pair<size_t, Access> Event;
+    typedef std::vector<bool> Slots;
+
+    /// Records all accesses to @p slot - unless its address escapes.
+    void collect(const Slot* slot) {
+        std::vector<std::pair<const Def*, Access>> accesses;
+        std::vector<const Def*> stack(1, slot);
+
+        while (!stack.empty()) {
+            auto def = stack.back();
+            stack.pop_back();
+
+            for (auto use : def->uses()) {
+                if (!scope_.contains(use))
+                    return;
+                if ((use->isa<LEA>() || use->isa<Bitcast>()) && use.index() == 0)
+                    stack.push_back(use);
+                else if (use->isa<Load>() && use.index() == 1)
+                    accesses.emplace_back(use, Read);
+                else if (use->isa<Store>() && use.index() == 1)
+                    accesses.emplace_back(use, def == slot ? Kill : Write);
+                else
+                    return;
+            }
+        }
+
+        auto index = slots_.size();
+        slots_.push_back(slot);
+        for (const auto& p : accesses)
+            memop2access_[p.first] = Event(index, p.second);
+    }
+
+    Slots none() const { return Slots(slots_.size(), false); }
+    static void join(Slots& slots, const Slots& other) {
+        for (size_t i = 0, e = slots.size(); i != e; ++i)
+            slots[i] = slots[i] || other[i];
+    }
+
+    Slots written_in(const Schedule::Block& block) const {
+        auto written = none();
+        for (auto pred : schedule_.cfg().preds(block.node()))
+            join(written, written_out_[schedule_[pred]]);
+        return written;
+    }
+
+    Slots live_out(const Schedule::Block& block) const {
+        auto live = none();
+        for (auto succ : schedule_.cfg().succs(block.node()))
+            join(live, live_in_[schedule_[succ]]);
+        return live;
+    }
+
+    /// Forwards: which slots may have been written so far? The contents of the others are undefined anyway.
+    void compute_written() {
+        for (bool todo = true; todo;) {
+            todo = false;
+            for (auto n : schedule_.cfg().reverse_post_order()) {
+                const auto& block = schedule_[n];
+                auto written = written_in(block);
+                for (const auto& event : events_[block]) {
+                    if (event.second != Read)
+                        written[event.first] = true;
+                }
+                if (written != written_out_[block]) {
+                    written_out_[block] = std::move(written);
+                    todo = true;
+                }
+            }
+        }
+    }
+
+    /// Backwards: which slots may be read later on without being overwritten as a whole before?
+    void compute_live() {
+        for (bool todo = true; todo;) {
+            todo = false;
+            for (auto n : schedule_.cfg().post_order()) {
+                const auto& block = schedule_[n];
+                auto live = live_out(block);
+                const auto& events = events_[block];
+                for (auto i = events.rbegin(), e = events.rend(); i != e; ++i)
+                    transfer(*i, live);
+                if (live != live_in_[block]) {
+                    live_in_[block] = std::move(live);
+                    todo = true;
+                }
+            }
+        }
+    }
+
+    static void transfer(const Event& event, Slots& live) {
+        if (event.second == Read)
+            live[event.first] = true;
+        else if (event.second == Kill)
+            live[event.first] = false;
+    }
+
+    /**
+     * A write to a slot clobbers all other slots which hold a value that is still needed afterwards.
+     * These interfere if they share their storage.
+     */
+    void compute_interference() {
+        interference_.assign(slots_.size(), none());
+
+        for (const auto& block : schedule_) {
+            const auto& events = events_[block];
+
+            // the written slots right before each event
+            std::vector<Slots> written_before;
+            auto written = written_in(block);
+            for (const auto& event : events) {
+                written_before.push_back(written);
+                if (event.second != Read)
+                    written[event.first] = true;
+            }
+
+            auto live = live_out(block);
+            for (size_t i = events.size(); i-- != 0;) {
+                auto slot = events[i].first;
+                if (events[i].second != Read) {
+                    for (size_t other = 0, e = slots_.size(); other != e; ++other) {
+                        if (other != slot && live[other] && written_before[i][other])
+                            interference_[slot][other] = interference_[other][slot] = true;
+                    }
+                }
+                transfer(events[i], live);
+            }
+        }
+    }
+
+    /// Greedily assigns each slot to the first class of its frame and type which it does not interfere with.
+    size_t merge() {
+        std::vector<std::vector<size_t>> classes;
+        size_t num_merged = 0;
+
+        for (size_t i = 0, e = slots_.size(); i != e; ++i) {
+            auto slot = slots_[i];
+            auto fits = [&] (const std::vector<size_t>& members) {
+                auto rep = slots_[members.front()];
+                if (rep->frame() != slot->frame() || rep->type() != slot->type())
+                    return false;
+                for (auto member : members) {
+                    if (interference_[i][member])
+                        return false;
+                }
+                return true;
+            };
+
+            auto c = std::find_if(classes.begin(), classes.end(), fits);
+            if (c == classes.end()) {
+                classes.emplace_back(1, i);
+            } else {
+                DLOG("merging {} into {}", slot, slots_[c->front()]);
+                slot->replace(slots_[c->front()]);
+                c->push_back(i);
+                ++num_merged;
+            }
+        }
+
+        return num_merged;
+    }
+
+    const Scope& scope_;
+    const Schedule schedule_;
+    std::vector<const Slot*> slots_;
+    DefMap<Event> memop2access_;
+    Schedule::Map<std::vector<Event>> events_ = Schedule::Map<std::vector<Event>>(schedule_);
+    Schedule::Map<Slots> written_out_ = Schedule::Map<Slots>(schedule_);
+    Schedule::Map<Slots> live_in_ = Schedule::Map<Slots>(schedule_);
+    std::vector<Slots> interference_;
+};
+
+void color_slots(World& world) {
+    size_t num_merged = 0;
+    Scope::for_each(world, [&] (const Scope& scope) { num_merged += SlotColoring(scope).run(); });
+    VLOG("slot coloring: merged {} slots", num_merged);
+    debug_verify(world);
+}
+
+}
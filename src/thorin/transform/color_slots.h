@@ -0,0 +1,16 @@
+#ifndef THORIN_TRANSFORM_COLOR_SLOTS_H
+#define THORIN_TRANSFORM_COLOR_SLOTS_H
+
+namespace thorin {
+
+class World;
+
+/**
+ * Merges @p Slot%s of the same frame and type whose live ranges do not overlap.
+ * Only @p Slot%s that are exclusively accessed via @p Load%s and @p Store%s - possibly through @p LEA%s and @p Bitcast%s - are considered.
+ */
+void color_slots(World&);
+
+}
+
+#endif
@@ -1,6 +1,8 @@
 #include "thorin/primop.h"
+#include "thorin/analyses/alias.h"
 #include "thorin/analyses/cfg.h"
 #include "thorin/analyses/scope.h"
+#include "thorin/util/log.h"
 
 namespace thorin {
 
@@ -22,6 +24,20 @@ static void dead_load_opt(const Scope& scope) {
                     if (memop->isa<Load>() || memop->isa<Enter>()) {
                         if (memop->out(1)->num_uses() == 0)
                             memop->out_mem()->replace(memop->mem());
+                        else if (auto load = memop->isa<Load>()) {
+                            // forward a previously stored or loaded value
+                            if (auto val = find_value(load->mem(), load->ptr())) {
+                                DLOG("forwarding {} to {}", val, load);
+                                load->out_val()->replace(val);
+                                load->out_mem()->replace(load->mem());
+                            }
+                        }
+                    } else if (auto store = memop->isa<Store>()) {
+                        // the location already holds this value
+                        if (find_value(store->mem(), store->ptr()) == store->val()) {
+                            DLOG("removing redundant {}", store);
+                            store->replace(store->mem());
+                        }
                     }
                     mem = memop->mem();
                 } else if (auto extract = mem->isa<Extract>()) {
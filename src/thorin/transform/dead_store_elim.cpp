@@ -0,0 +1,160 @@
+#include <algorithm>
+
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/alias.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+/// Is there any @p Load from the memory of @p object?
+static bool is_read(const Def* object) {
+    return any_ptr_use(object, [] (Use use) { return use->isa<Load>() != nullptr; });
+}
+
+class DeadStoreElim {
+public:
+    DeadStoreElim(const Scope& scope)
+        : scope_(scope)
+    {}
+
+    size_t run() {
+        remove_unread_stores();
+        for (auto n : scope_.f_cfg().post_order())
+            remove_overwritten_stores(n->continuation());
+        return num_removed_;
+    }
+
+private:
+    bool is_local(const Def* object) const {
+        return (object->isa<Slot>() || Alloc::is_out_ptr(object)) && scope_.contains(object) && !is_escaping(object);
+    }
+
+    void remove(const Store* store) {
+        DLOG("removing dead {}", store);
+        store->replace(store->mem());
+        ++num_removed_;
+    }
+
+    /// Stores to non-escaping @p Slot%s and @p Alloc%s which are never loaded from.
+    void remove_unread_stores() {
+        std::vector<const Store*> stores;
+        for (auto def : scope_.defs()) {
+            if (auto store = def->isa<Store>())
+                stores.push_back(store);
+        }
+
+        DefMap<bool> object2dead;
+        for (auto store : stores) {
+            auto object = MemLoc(store->ptr()).object();
+            auto p = object2dead.emplace(object, false);
+            if (p.second)
+                p.first->second = is_local(object) && !is_read(object);
+            if (p.first->second)
+                remove(store);
+        }
+    }
+
+    /**
+     * Walks the mem chain of @p continuation upwards.
+     * A store is dead if a later store of the same continuation overwrites the very same location
+     * or if the frame of its @p Slot ends with this continuation - and nothing reads the location in between.
+     */
+    void remove_overwritten_stores(Continuation* continuation) {
+        const Def* mem = nullptr;
+        for (auto arg : continuation->args()) {
+            if (is_mem(arg)) {
+                mem = arg;
+                break;
+            }
+        }
+        if (mem == nullptr)
+            return;
+
+        std::vector<MemLoc> killed;     // locations written later on without being read in between
+        std::vector<const Def*> loaded; // locations read later on
+        bool frame_ends = continuation->callee() == scope_.entry()->ret_param();
+        const Def* from = continuation;
+
+        auto read = [&] (const Def* ptr) {
+            MemLoc loc(ptr);
+            killed.erase(std::remove_if(killed.begin(), killed.end(), [&] (const MemLoc& k) {
+                return alias(k, loc) != AliasResult::No;
+            }), killed.end());
+            loaded.push_back(ptr);
+        };
+
+        auto clobber = [&] () {
+            killed.clear();
+            frame_ends = false;
+        };
+
+        while (true) {
+            // loads which have been taken off the chain still read the memory state at mem
+            if (is_mem(mem)) {
+                for (auto use : mem->uses()) {
+                    if (use.def() == from)
+                        continue;
+                    if (auto load = use->isa<Load>())
+                        read(load->ptr());
+                    else
+                        clobber();
+                }
+            }
+
+            if (auto extract = mem->isa<Extract>()) {
+                from = extract;
+                mem = extract->agg();
+                continue;
+            }
+
+            auto memop = mem->isa<MemOp>();
+            if (memop == nullptr)
+                break;
+
+            if (auto store = memop->isa<Store>()) {
+                MemLoc loc(store->ptr());
+                bool dead = std::any_of(killed.begin(), killed.end(), [&] (const MemLoc& k) {
+                    return alias(k, loc) == AliasResult::Must;
+                });
+
+                if (!dead && frame_ends) {
+                    auto slot = loc.object()->isa<Slot>();
+                    dead = slot && is_local(slot) && std::none_of(loaded.begin(), loaded.end(), [&] (const Def* ptr) {
+                        return alias(MemLoc(ptr), loc) != AliasResult::No;
+                    });
+                }
+
+                mem = store->mem();
+                if (dead) {
+                    remove(store); // 'from' now uses mem
+                } else {
+                    killed.emplace_back(loc);
+                    from = store;
+                }
+                continue;
+            }
+
+            if (auto load = memop->isa<Load>())
+                read(load->ptr());
+            else if (!memop->isa<Enter>() && !memop->isa<Alloc>() && !memop->isa<Prefetch>())
+                clobber();
+
+            from = memop;
+            mem = memop->mem();
+        }
+    }
+
+    const Scope& scope_;
+    size_t num_removed_ = 0;
+};
+
+void dead_store_elim(World& world) {
+    size_t num_removed = 0;
+    Scope::for_each(world, [&] (const Scope& scope) { num_removed += DeadStoreElim(scope).run(); });
+    VLOG("dead store elimination: removed {} stores", num_removed);
+}
+
+}
@@ -0,0 +1,12 @@
+#ifndef THORIN_TRANSFORM_DEAD_STORE_ELIM_H
+#define THORIN_TRANSFORM_DEAD_STORE_ELIM_H
+
+namespace thorin {
+
+class World;
+
+void dead_store_elim(World&);
+
+}
+
+#endif
@@ -0,0 +1,198 @@
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/alias.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/domtree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+/**
+ * Global value numbering for @p Load%s.
+ * Pure @p PrimOp%s are already numbered globally by @p World::cse and float freely in the graph.
+ * @p MemOp%s, however, are never merged.
+ * This pass reuses values which are available in all predecessors of a @p Continuation via a new param
+ * and inserts @p Load%s into predecessors entering a loop where a value is only partially available.
+ */
+class GVN {
+public:
+    GVN(const Scope& scope)
+        : scope_(scope)
+        , cfg_(scope.f_cfg())
+        , domtree_(cfg_.domtree())
+    {
+        for (const auto& block : schedule(scope, Schedule::Early)) {
+            for (auto primop : block)
+                def2early_[primop] = block.node();
+        }
+    }
+
+    size_t run();
+
+private:
+    World& world() const { return scope_.world(); }
+    bool dominates(const CFNode* n, const CFNode* m) const { return domtree_.lca(n, m) == n; }
+    bool is_available(const Def* def, const CFNode* n) const;
+    std::vector<Continuation*> direct_preds(Continuation*) const;
+    const Def* find_value(const Def* mem, const Def* ptr) const;
+    bool try_reuse(const CFNode* n, const Load* load);
+
+    static const int max_depth = 8;
+
+    const Scope& scope_;
+    const F_CFG& cfg_;
+    const DomTree& domtree_;
+    DefMap<const CFNode*> def2early_;
+};
+
+/// Is @p def defined in a block dominating @p n?
+bool GVN::is_available(const Def* def, const CFNode* n) const {
+    const CFNode* early = nullptr;
+    if (auto param = def->isa<Param>()) {
+        if (scope_.contains(param->continuation()))
+            early = cfg_[param->continuation()];
+    } else {
+        auto i = def2early_.find(def);
+        if (i != def2early_.end())
+            early = i->second;
+    }
+
+    return early == nullptr || dominates(early, n);
+}
+
+/// Returns all predecessors of @p continuation if all of them jump directly to it; otherwise the result is empty.
+std::vector<Continuation*> GVN::direct_preds(Continuation* continuation) const {
+    std::vector<Continuation*> preds;
+    if (continuation == scope_.entry())
+        return preds;
+
+    for (auto use : continuation->uses()) {
+        auto pred = use->isa_continuation();
+        if (use.index() != 0 || pred == nullptr || !scope_.contains(pred)) {
+            preds.clear();
+            break;
+        }
+        preds.push_back(pred);
+    }
+
+    return preds;
+}
+
+/// Like @p thorin::find_value but continues the search in the predecessor of a continuation with a single predecessor.
+const Def* GVN::find_value(const Def* mem, const Def* ptr) const {
+    for (int i = 0; i != max_depth; ++i) {
+        const Def* stop = nullptr;
+        if (auto val = thorin::find_value(mem, ptr, &stop))
+            return val;
+
+        auto param = stop->isa<Param>();
+        if (param == nullptr || !scope_.contains(param->continuation()))
+            return nullptr;
+
+        auto n = cfg_[param->continuation()];
+        auto preds = direct_preds(param->continuation());
+        if (n == nullptr || n == cfg_.entry() || preds.size() != 1 || !is_available(ptr, domtree_.idom(n)))
+            return nullptr;
+
+        mem = preds.front()->arg(param->index());
+    }
+
+    return nullptr;
+}
+
+bool GVN::try_reuse(const CFNode* n, const Load* load) {
+    auto continuation = n->continuation();
+    auto param = continuation->mem_param();
+    auto ptr = load->ptr();
+
+    // ptr must not depend on this continuation's params - otherwise it refers to something else in the preds
+    if (n == cfg_.entry() || !is_available(ptr, domtree_.idom(n)))
+        return false;
+
+    auto preds = direct_preds(continuation);
+    if (preds.empty())
+        return false;
+
+    Array<const Def*> vals(preds.size());
+    size_t num_available = 0;
+    for (size_t i = 0, e = preds.size(); i != e; ++i) {
+        if ((vals[i] = find_value(preds[i]->arg(param->index()), ptr)))
+            ++num_available;
+    }
+
+    if (num_available == 0)
+        return false;
+
+    // only insert loads on edges which execute the load anyway and which don't come from within a loop
+    for (size_t i = 0, e = preds.size(); i != e; ++i) {
+        if (vals[i] == nullptr) {
+            auto pn = cfg_[preds[i]];
+            if (pn == nullptr || cfg_.num_succs(pn) != 1 || dominates(n, pn))
+                return false;
+        }
+    }
+
+    for (size_t i = 0, e = preds.size(); i != e; ++i) {
+        if (vals[i] == nullptr) {
+            auto pred = preds[i];
+            auto nload = world().load(pred->arg(param->index()), ptr, load->debug(), load->flags());
+            pred->update_arg(param->index(), world().extract(nload, 0_u32));
+            vals[i] = world().extract(nload, 1_u32);
+        }
+    }
+
+    const Def* val = vals.front();
+    for (auto v : vals) {
+        if (v != val || !is_available(v, n)) {
+            val = nullptr;
+            break;
+        }
+    }
+
+    if (val == nullptr) {
+        auto nparam = continuation->append_param(load->out_val_type(), load->debug());
+        for (size_t i = 0, e = preds.size(); i != e; ++i)
+            preds[i]->jump(continuation, concat(preds[i]->args(), vals[i]), preds[i]->jump_debug());
+        val = nparam;
+    }
+
+    DLOG("reusing {} for {} in {}", val, load, continuation);
+    load->out_val()->replace(val);
+    load->out_mem()->replace(load->mem());
+    return true;
+}
+
+size_t GVN::run() {
+    size_t num_removed = 0;
+
+    // loads are considered where code generation will place them
+    auto smart = schedule(scope_, Schedule::Smart);
+    for (const auto& block : smart) {
+        auto n = block.node();
+        auto param = n->continuation()->mem_param();
+        if (param == nullptr)
+            continue;
+
+        for (auto primop : block) {
+            if (auto load = primop->isa<Load>()) {
+                const Def* stop = nullptr;
+                if (thorin::find_value(load->mem(), load->ptr(), &stop) || stop != param)
+                    continue;
+                if (try_reuse(n, load))
+                    ++num_removed;
+            }
+        }
+    }
+
+    return num_removed;
+}
+
+void gvn(World& world) {
+    size_t num_removed = 0;
+    Scope::for_each(world, [&] (const Scope& scope) { num_removed += GVN(scope).run(); });
+    VLOG("gvn: removed {} loads", num_removed);
+}
+
+}
@@ -0,0 +1,12 @@
+#ifndef THORIN_TRANSFORM_GVN_H
+#define THORIN_TRANSFORM_GVN_H
+
+namespace thorin {
+
+class World;
+
+void gvn(World&);
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "thorin/transform/heap2stack.h"
+
+#include <algorithm>
+
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/alias.h"
+#include "thorin/analyses/range.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/analyses/verify.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+static const u64 unknown_size = u64(-1);
+
+/// Estimates the size of @p type in bytes without any padding - @c unknown_size if there is no such size.
+static u64 size_of(const Type* type) {
+    if (auto prim = type->isa<PrimType>())
+        return (num_bits(prim->primtype_tag()) + 7) / 8 * prim->length();
+    if (type->isa<PtrType>())
+        return 8 * type->as<PtrType>()->length();
+    if (auto array = type->isa<DefiniteArrayType>()) {
+        auto elem = size_of(array->elem_type());
+        if (elem == unknown_size || (elem != 0 && array->dim() > unknown_size / elem))
+            return unknown_size;
+        return array->dim() * elem;
+    }
+    if (type->isa<TupleType>() || type->isa<StructType>()) {
+        u64 size = 0;
+        for (auto op : type->ops()) {
+            auto s = size_of(op);
+            if (s == unknown_size || size + s < size)
+                return unknown_size;
+            size += s;
+        }
+        return size;
+    }
+    return unknown_size;
+}
+
+/// Is @p ptr or a pointer derived from it promised to be aligned by an @p Aligned hint?
+static bool has_alignment_hint(const Def* ptr) {
+    for (auto use : ptr->uses()) {
+        if (use->isa<Aligned>())
+            return true;
+        if (((use->isa<LEA>() && use.index() == 0) || (use->isa<ConvOp>() && use->type()->isa<PtrType>())) && has_alignment_hint(use))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Is @p alloc only accessed by its pointer which in turn does not leave the function?
+ * A @p Slot merely gets the ABI alignment of its type; thus, allocs with alignment hints stay on the heap.
+ */
+static bool is_local(const Alloc* alloc) {
+    for (auto use : alloc->uses()) {
+        if (!use->isa<Extract>())
+            return false;
+    }
+    return !is_escaping(alloc->out_ptr()) && !has_alignment_hint(alloc->out_ptr());
+}
+
+class Heap2Stack {
+public:
+    Heap2Stack(const Scope& scope, size_t max_size)
+        : scope_(scope)
+        , max_size_(max_size)
+    {}
+
+    size_t run() {
+        std::vector<std::pair<const Alloc*, const Type*>> todo;
+        {
+            RangeAnalysis ranges(scope_);
+            for (const auto& block : schedule(scope_)) {
+                for (auto primop : block) {
+                    if (auto alloc = primop->isa<Alloc>()) {
+                        if (!is_local(alloc))
+                            continue;
+                        if (auto type = stack_type(alloc, ranges, block.continuation()))
+                            todo.emplace_back(alloc, type);
+                    }
+                }
+            }
+        }
+
+        for (const auto& p : todo)
+            promote(p.first, p.second);
+        return todo.size();
+    }
+
+private:
+    /// The type of the @p Slot which replaces @p alloc or @c nullptr if its size is unknown or too large.
+    const Type* stack_type(const Alloc* alloc, const RangeAnalysis& ranges, Continuation* continuation) const {
+        auto type = alloc->alloced_type();
+        if (auto array = type->isa<IndefiniteArrayType>()) {
+            auto r = ranges.range(alloc->extra(), continuation);
+            if (!r.is_known() || r.lo() < 0)
+                return nullptr;
+            type = scope_.world().definite_array_type(array->elem_type(), std::max(r.hi(), s64(1)));
+        }
+
+        auto size = size_of(type);
+        return size <= max_size_ ? type : nullptr;
+    }
+
+    void promote(const Alloc* alloc, const Type* type) {
+        auto& world = scope_.world();
+        DLOG("moving {} of type {} to the stack", alloc, type);
+
+        auto enter = world.enter(alloc->mem(), alloc->debug());
+        auto slot = world.slot(type, world.extract(enter, 1_u32), alloc->debug());
+        auto ptr = type == alloc->alloced_type() ? slot : world.bitcast(alloc->out_ptr_type(), slot, alloc->debug());
+        alloc->replace(world.tuple({world.extract(enter, 0_u32), ptr}, alloc->debug()));
+    }
+
+    const Scope& scope_;
+    size_t max_size_;
+};
+
+void heap2stack(World& world, size_t max_size) {
+    size_t num_promoted = 0;
+    Scope::for_each(world, [&] (const Scope& scope) { num_promoted += Heap2Stack(scope, max_size).run(); });
+    VLOG("heap2stack: moved {} allocs to the stack", num_promoted);
+    debug_verify(world);
+    world.cleanup();
+}
+
+}
@@ -0,0 +1,19 @@
+#ifndef THORIN_TRANSFORM_HEAP2STACK_H
+#define THORIN_TRANSFORM_HEAP2STACK_H
+
+#include <cstddef>
+
+namespace thorin {
+
+class World;
+
+/**
+ * Replaces each @p Alloc whose pointer does not escape its function by a @p Slot.
+ * Arrays of a variable size become @p Slot%s of the largest size their @p Alloc::extra may have according to the @p RangeAnalysis.
+ * @p Alloc%s of more than roughly @p max_size bytes stay on the heap.
+ */
+void heap2stack(World&, size_t max_size = 4096);
+
+}
+
+#endif
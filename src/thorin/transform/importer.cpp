@@ -28,6 +28,13 @@ const Type* Importer::import(const Type* otype) {
     return ntype;
 }
 
+/*
+ * Defs are imported in post-order with an explicit stack instead of recursing through the operands.
+ * A Continuation is imported in two steps:
+ * First, a stub is created which allows cyclic references to it and to its Params.
+ * The Continuation stays pending on the stack until all operands of its body have been imported.
+ */
+
 const Def* Importer::import(Tracker odef) {
     if (auto ndef = find(def_old2new_, odef)) {
         assert(&ndef->world() == &world_);
@@ -35,75 +42,138 @@ const Def* Importer::import(Tracker odef) {
         return ndef;
     }
 
-    auto ntype = import(odef->type());
+    std::vector<const Def*> stack;
+    ContinuationSet pending;
+    stack.push_back(odef);
+
+    // returns whether @p odef has already been imported - otherwise it is pushed onto the stack
+    auto imported = [&](const Def* odef) {
+        odef = Tracker(odef).def();
+        if (def_old2new_.contains(odef))
+            return true;
+        stack.push_back(odef);
+        return false;
+    };
+    auto lookup = [&](const Def* odef) {
+        auto ndef = find(def_old2new_, Tracker(odef).def());
+        assert(ndef && &ndef->world() == &world());
+        assert(!ndef->is_replaced());
+        return ndef;
+    };
+    // pushes in reverse order such that the operands are imported from left to right
+    auto all_imported = [&](Defs odefs) {
+        bool result = true;
+        for (size_t i = odefs.size(); i-- != 0;)
+            result &= imported(odefs[i]);
+        return result;
+    };
+
+    while (!stack.empty()) {
+        auto odef = stack.back();
+
+        if (def_old2new_.contains(odef)) {
+            auto ocontinuation = odef->isa_continuation();
+            if (ocontinuation == nullptr || !pending.contains(ocontinuation)) {
+                stack.pop_back();
+                continue;
+            }
+
+            // import the body of a pending continuation
+            auto ncontinuation = lookup(ocontinuation)->as_continuation();
+            if (ocontinuation->num_ops() > 0 && ocontinuation->callee() == ocontinuation->world().branch()) {
+                if (!imported(ocontinuation->arg(0)))
+                    continue;
+
+                if (auto lit = lookup(ocontinuation->arg(0))->isa<PrimLit>()) {
+                    auto ocallee = lit->value().get_bool() ? ocontinuation->arg(1) : ocontinuation->arg(2);
+                    if (!imported(ocallee))
+                        continue;
+
+                    ncontinuation->jump(lookup(ocallee), {}, ocontinuation->jump_debug());
+                    assert(!ncontinuation->is_replaced());
+                    pending.erase(ocontinuation);
+                    stack.pop_back();
+                    continue;
+                }
+            }
 
-    if (auto oparam = odef->isa<Param>()) {
-        import(oparam->continuation())->as_continuation();
-        auto nparam = find(def_old2new_, oparam);
-        assert(nparam && &nparam->world() == &world_);
-        assert(!nparam->is_replaced());
-        return nparam;
-    }
+            auto old_profile = ocontinuation->filter();
+            bool ready = all_imported(old_profile);
+            ready &= all_imported(ocontinuation->ops());
+            if (!ready)
+                continue;
+
+            Array<const Def*> new_profile(old_profile.size());
+            for (size_t i = 0, e = old_profile.size(); i != e; ++i)
+                new_profile[i] = lookup(old_profile[i]);
+            ncontinuation->set_filter(new_profile);
+
+            if (ocontinuation->num_ops() > 0) {
+                Array<const Def*> nargs(ocontinuation->num_args());
+                for (size_t i = 0, e = nargs.size(); i != e; ++i)
+                    nargs[i] = lookup(ocontinuation->arg(i));
+                ncontinuation->jump(lookup(ocontinuation->callee()), nargs, ocontinuation->jump_debug());
+            }
+            assert(!ncontinuation->is_replaced());
+            pending.erase(ocontinuation);
+            stack.pop_back();
+            continue;
+        }
 
-    Continuation* ncontinuation = nullptr;
-    if (auto ocontinuation = odef->isa_continuation()) { // create stub in new world
-        // TODO maybe we want to deal with intrinsics in a more streamlined way
-        if (ocontinuation == ocontinuation->world().branch())
-            return def_old2new_[ocontinuation] = world().branch();
-        if (ocontinuation == ocontinuation->world().end_scope())
-            return def_old2new_[ocontinuation] = world().end_scope();
-        auto npi = import(ocontinuation->type())->as<FnType>();
-        ncontinuation = world().continuation(npi, ocontinuation->cc(), ocontinuation->intrinsic(), ocontinuation->debug_history());
-        assert(&ncontinuation->world() == &world());
-        assert(&npi->table() == &world());
-        for (size_t i = 0, e = ocontinuation->num_params(); i != e; ++i) {
-            ncontinuation->param(i)->debug() = ocontinuation->param(i)->debug_history();
-            def_old2new_[ocontinuation->param(i)] = ncontinuation->param(i);
+        if (auto oparam = odef->isa<Param>()) {
+            // the params are registered together with the stub of their continuation
+            assert(!def_old2new_.contains(oparam->continuation()));
+            stack.push_back(oparam->continuation());
+            continue;
         }
 
-        def_old2new_[ocontinuation] = ncontinuation;
+        if (auto ocontinuation = odef->isa_continuation()) { // create stub in new world
+            // TODO maybe we want to deal with intrinsics in a more streamlined way
+            if (ocontinuation == ocontinuation->world().branch()) {
+                def_old2new_[ocontinuation] = world().branch();
+                stack.pop_back();
+                continue;
+            }
+            if (ocontinuation == ocontinuation->world().end_scope()) {
+                def_old2new_[ocontinuation] = world().end_scope();
+                stack.pop_back();
+                continue;
+            }
+            auto npi = import(ocontinuation->type())->as<FnType>();
+            auto ncontinuation = world().continuation(npi, ocontinuation->cc(), ocontinuation->intrinsic(), ocontinuation->debug_history());
+            assert(&ncontinuation->world() == &world());
+            assert(&npi->table() == &world());
+            for (size_t i = 0, e = ocontinuation->num_params(); i != e; ++i) {
+                ncontinuation->param(i)->debug() = ocontinuation->param(i)->debug_history();
+                def_old2new_[ocontinuation->param(i)] = ncontinuation->param(i);
+            }
 
-        if (ocontinuation->is_external())
-            ncontinuation->make_external();
+            def_old2new_[ocontinuation] = ncontinuation;
 
-        if (ocontinuation->num_ops() > 0 && ocontinuation->callee() == ocontinuation->world().branch()) {
-            auto cond = import(ocontinuation->arg(0));
-            if (auto lit = cond->isa<PrimLit>()) {
-                auto callee = import(lit->value().get_bool() ? ocontinuation->arg(1) : ocontinuation->arg(2));
-                ncontinuation->jump(callee, {}, ocontinuation->jump_debug());
+            if (ocontinuation->is_external())
+                ncontinuation->make_external();
 
-                assert(!ncontinuation->is_replaced());
-                return ncontinuation;
-            }
+            pending.emplace(ocontinuation);
+            continue;
         }
 
-        auto old_profile = ocontinuation->filter();
-        Array<const Def*> new_profile(old_profile.size());
-        for (size_t i = 0, e = old_profile.size(); i != e; ++i)
-            new_profile[i] = import(old_profile[i]);
-        ncontinuation->set_filter(new_profile);
-    }
+        auto oprimop = odef->as<PrimOp>();
+        if (!all_imported(oprimop->ops()))
+            continue;
 
-    size_t size = odef->num_ops();
-    Array<const Def*> nops(size);
-    for (size_t i = 0; i != size; ++i) {
-        nops[i] = import(odef->op(i));
-        assert(&nops[i]->world() == &world());
-    }
+        size_t size = oprimop->num_ops();
+        Array<const Def*> nops(size);
+        for (size_t i = 0; i != size; ++i)
+            nops[i] = lookup(oprimop->op(i));
 
-    if (auto oprimop = odef->isa<PrimOp>()) {
-        auto nprimop = oprimop->rebuild(world(), nops, ntype);
+        auto nprimop = oprimop->rebuild(world(), nops, import(oprimop->type()));
         todo_ |= oprimop->tag() != oprimop->tag();
         assert(!nprimop->is_replaced());
-        return def_old2new_[oprimop] = nprimop;
+        def_old2new_[oprimop] = nprimop;
+        stack.pop_back();
     }
 
-    auto ocontinuation = odef->as_continuation();
-    assert(ncontinuation && &ncontinuation->world() == &world());
-    if (size > 0)
-        ncontinuation->jump(nops.front(), nops.skip_front(), ocontinuation->jump_debug());
-    assert(!ncontinuation->is_replaced());
-    return ncontinuation;
+    return lookup(odef);
 }
 
 }
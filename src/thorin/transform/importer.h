@@ -13,6 +13,7 @@ public:
     {
         if  (src.is_pe_done())
             world_.mark_pe_done();
+        world_.set_fast_math(src.fast_math());
 #if THORIN_ENABLE_CHECKS
         if (src.track_history())
             world_.enable_history(true);
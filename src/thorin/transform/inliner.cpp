@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
 #include "thorin/continuation.h"
+#include "thorin/primop.h"
 #include "thorin/world.h"
 #include "thorin/analyses/cfg.h"
+#include "thorin/analyses/looptree.h"
 #include "thorin/analyses/scope.h"
 #include "thorin/analyses/verify.h"
+#include "thorin/transform/inliner.h"
 #include "thorin/transform/mangle.h"
 #include "thorin/util/log.h"
 
@@ -35,11 +42,49 @@ void force_inline(Scope& scope, int threshold) {
     }
 }
 
-void inliner(World& world) {
-    VLOG("start inliner");
+/**
+ * Estimates the size of @p scope's body when called with @p args.
+ * Literals are free and so are all @p PrimOp%s which only depend on constant arguments as they will be folded.
+ */
+static size_t estimate_size(const Scope& scope, Defs args) {
+    auto entry = scope.entry();
+    DefSet folded;
+    std::queue<const Def*> queue;
+    for (size_t i = 0, e = args.size(); i != e; ++i) {
+        if (args[i]->isa<PrimLit>() || args[i]->isa_continuation()) {
+            folded.insert(entry->param(i));
+            queue.push(entry->param(i));
+        }
+    }
+
+    auto is_folded = [&] (const Def* def) {
+        return def->isa<PrimLit>() || folded.contains(def) || !scope.contains(def);
+    };
+
+    while (!queue.empty()) {
+        for (auto use : pop(queue)->uses()) {
+            if (auto primop = use->isa<PrimOp>()) {
+                if (primop->isa<MemOp>() || folded.contains(primop) || !scope.contains(primop))
+                    continue;
+                if (std::all_of(primop->ops().begin(), primop->ops().end(), is_folded)) {
+                    folded.insert(primop);
+                    queue.push(primop);
+                }
+            }
+        }
+    }
 
-    static const int factor = 4;
-    static const int offset = 4;
+    size_t size = 0;
+    for (auto def : scope.defs()) {
+        if (def->isa_continuation() || (def->isa<PrimOp>() && !def->isa<PrimLit>() && !folded.contains(def)))
+            ++size;
+    }
+
+    return size;
+}
+
+void inliner(World& world, const InlinerConfig& config) {
+    VLOG("start inliner");
 
     ContinuationMap<std::unique_ptr<Scope>> continuation2scope;
 
@@ -50,10 +95,19 @@ void inliner(World& world) {
         return i->second.get();
     };
 
-    auto is_candidate = [&] (Continuation* continuation) -> Scope* {
-        if (!continuation->empty() && continuation->order() > 1) {
-            auto scope = get_scope(continuation);
-            if (scope->defs().size() < scope->entry()->num_params() * factor + offset)
+    // global code growth budget
+    size_t initial_size = world.primops().size();
+    size_t max_growth = std::max(size_t(initial_size * config.growth), config.min_growth);
+    size_t budget = max_growth;
+
+    auto is_candidate = [&] (Continuation* continuation, double frequency, size_t& size) -> Scope* {
+        auto callee = continuation->callee()->as_continuation();
+        if (!callee->empty() && callee->order() > 1) {
+            auto scope = get_scope(callee);
+            size = estimate_size(*scope, continuation->args());
+            size_t threshold = (config.threshold + callee->num_params() * config.param_bonus) * frequency;
+            DLOG("size: {}, threshold: {}, budget: {}", size, threshold, budget);
+            if (size <= threshold && size <= budget)
                 return scope;
         }
         return nullptr;
@@ -61,15 +115,25 @@ void inliner(World& world) {
 
     Scope::for_each(world, [&] (Scope& scope) {
         bool dirty = false;
+        const auto& looptree = scope.f_cfg().looptree();
         for (auto n : scope.f_cfg().post_order()) {
             auto continuation = n->continuation();
             if (auto callee = continuation->callee()->isa_continuation()) {
                 if (callee == scope.entry())
                     continue; // don't inline recursive calls
                 DLOG("callee: {}", callee);
-                if (auto callee_scope = is_candidate(callee)) {
+                double frequency = 1 + config.loop_factor * (looptree[n]->depth() - 1); // leaves outside of any loop have depth 1
+                u64 count, entry_count;
+                if (world.profile().lookup(continuation, count) && world.profile().lookup(scope.entry(), entry_count)) {
+                    // each factor of ten by which the call site runs more often than its function counts as one loop level
+                    double ratio = double(count) / double(std::max(entry_count, u64(1)));
+                    frequency = count == 0 ? 0.0 : 1 + config.loop_factor * std::max(0.0, std::log10(ratio));
+                }
+                size_t size;
+                if (auto callee_scope = is_candidate(continuation, frequency, size)) {
                     DLOG("- here: {}", continuation);
                     continuation->jump(drop(*callee_scope, continuation->args()), {}, continuation->jump_debug());
+                    budget -= size;
                     dirty = true;
                 }
             }
@@ -83,7 +147,7 @@ void inliner(World& world) {
         }
     });
 
-    VLOG("stop inliner");
+    VLOG("stop inliner: grew by {} of {} primops", max_growth - budget, initial_size);
     debug_verify(world);
     world.cleanup();
 }
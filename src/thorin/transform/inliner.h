@@ -1,17 +1,33 @@
 #ifndef THORIN_TRANSFORM_INLINER_H
 #define THORIN_TRANSFORM_INLINER_H
 
+#include <cstddef>
+
 namespace thorin {
 
+class Scope;
 class World;
 
+/// Parameters of @p inliner's cost model.
+struct InlinerConfig {
+    int threshold = 4;           ///< Maximum estimated size of a callee at a call site outside of any loop ...
+    int param_bonus = 4;         ///< ... plus this for each param of the callee ...
+    int loop_factor = 2;         ///< ... multiplied by (1 + @c loop_factor * loop depth of the call site); a @p Profile overrides the loop depth.
+    double growth = 0.5;         ///< Inlining stops once the @p World has grown by this fraction of its initial size ...
+    size_t min_growth = 1024;    ///< ... but not before it has grown by this many @p PrimOp%s.
+};
+
 /**
  * Forces inlining of all callees within @p scope that are not defined in @p scope.
  * There are at most @p threshold many inlining runs performed.
  * If there still remain functions to be inlined, warnings will be emitted
  */
 void force_inline(Scope& scope, int threshold);
-void inliner(World& world);
+/**
+ * Inlines callees whose estimated size fits the threshold of their call site according to @p config.
+ * The size of a callee does not count operations which fold away due to constant arguments.
+ */
+void inliner(World& world, const InlinerConfig& config = InlinerConfig());
 
 }
 
@@ -0,0 +1,113 @@
+#include "thorin/transform/insert_prefetches.h"
+
+#include <algorithm>
+
+#include "thorin/continuation.h"
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/alias.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/induction.h"
+#include "thorin/analyses/looptree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/analyses/verify.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+/// Is @p index the induction variable of @p loop plus something invariant?
+static bool is_strided(const InductionLoop& loop, const Def* index) {
+    auto var = loop.exit_var()->param;
+    if (index == var)
+        return true;
+    if (auto add = index->isa<ArithOp>()) {
+        if (add->arithop_tag() == ArithOp_add)
+            return (add->lhs() == var && loop.is_invariant(add->rhs())) || (add->rhs() == var && loop.is_invariant(add->lhs()));
+    }
+    return false;
+}
+
+/// Yields the address @p ptr points to @p distance iterations of @p loop later or @c nullptr if it does not advance in a regular way.
+static const Def* advance(const InductionLoop& loop, const Def* ptr, s64 distance) {
+    auto& world = ptr->world();
+    MemLoc loc(ptr);
+    if (!loop.is_invariant(loc.base()) || loc.object()->isa<Slot>())
+        return nullptr;
+
+    bool strided = false;
+    auto result = loc.base();
+    for (auto index : loc.path()) {
+        if (is_strided(loop, index)) {
+            auto offset = world.cast(index->type(), world.literal_qs64(distance * loop.exit_var()->step, {}));
+            index = world.arithop_add(index, offset, index->debug());
+            strided = true;
+        } else if (!loop.is_invariant(index)) {
+            return nullptr;
+        }
+        result = world.lea(result, index, ptr->debug());
+    }
+
+    return strided ? result : nullptr;
+}
+
+static size_t insert_prefetches(const Scope& scope, size_t distance) {
+    Induction induction(scope.f_cfg().looptree());
+    if (induction.loops().empty())
+        return 0;
+
+    // only innermost loops
+    std::vector<const InductionLoop*> loops;
+    for (const auto& loop : induction.loops()) {
+        if (loop->exit_var() == nullptr || loop->exit_var()->step == 0)
+            continue;
+        if (std::none_of(induction.loops().begin(), induction.loops().end(), [&] (const std::unique_ptr<InductionLoop>& other) {
+                return other->node()->parent() == loop->node(); }))
+            loops.push_back(loop.get());
+    }
+
+    std::vector<std::pair<const Access*, const Def*>> todo;
+    Schedule schedule(scope);
+    for (auto loop : loops) {
+        DefSet done;
+        for (auto& block : schedule) {
+            if (!loop->contains(block.continuation()))
+                continue;
+
+            for (auto primop : block) {
+                auto access = primop->isa<Access>();
+                if (access == nullptr || access->is_nontemporal())
+                    continue;
+                if (auto ptr = advance(*loop, access->ptr(), distance)) {
+                    // one prefetch per address suffices
+                    if (done.emplace(ptr).second)
+                        todo.emplace_back(access, ptr);
+                }
+            }
+        }
+    }
+
+    auto& world = scope.world();
+    for (const auto& p : todo) {
+        auto access = p.first;
+        DLOG("prefetching {} for {}", p.second, access);
+        Array<const Def*> ops(access->ops());
+        ops[0] = world.prefetch(access->mem(), p.second, access->isa<Store>() != nullptr, 3, access->debug());
+        access->replace(access->rebuild(ops));
+    }
+
+    return todo.size();
+}
+
+void insert_prefetches(World& world, size_t distance) {
+    VLOG("start insert prefetches");
+
+    size_t num = 0;
+    Scope::for_each(world, [&] (const Scope& scope) { num += insert_prefetches(scope, distance); });
+
+    VLOG("stop insert prefetches: {} prefetches inserted", num);
+    debug_verify(world);
+    world.cleanup();
+}
+
+}
@@ -0,0 +1,21 @@
+#ifndef THORIN_TRANSFORM_INSERT_PREFETCHES_H
+#define THORIN_TRANSFORM_INSERT_PREFETCHES_H
+
+#include <cstddef>
+
+namespace thorin {
+
+class World;
+
+/**
+ * Software prefetching for strided accesses in innermost @p InductionLoop%s.
+ * A @p Load or @p Store whose address advances with the induction variable of its loop - each index is either invariant
+ * or the induction variable plus something invariant - is preceded by a @p Prefetch of the address it is going to access
+ * @p distance iterations later.
+ * This is not part of @p World::opt as hardware prefetchers usually cope with such simple patterns on their own.
+ */
+void insert_prefetches(World& world, size_t distance = 8);
+
+}
+
+#endif
@@ -0,0 +1,280 @@
+#include "thorin/transform/licm.h"
+
+#include "thorin/continuation.h"
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/alias.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/domtree.h"
+#include "thorin/analyses/induction.h"
+#include "thorin/analyses/looptree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/analyses/verify.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+/// Does @p ptr point into a @p Slot, @p Global or fixed-size @p Alloc via in-bounds constant indices only?
+static bool is_dereferenceable(const Def* ptr) {
+    MemLoc loc(ptr);
+    if (loc.is_casted() || !is_identified_object(loc.base()))
+        return false;
+
+    auto type = loc.base()->type()->as<PtrType>()->pointee();
+    for (auto index : loc.path()) {
+        if (!index->isa<PrimLit>())
+            return false;
+        auto i = primlit_value<u64>(index);
+        if (auto array = type->isa<DefiniteArrayType>()) {
+            if (i >= array->dim())
+                return false;
+            type = array->elem_type();
+        } else if (type->isa<TupleType>() || type->isa<StructType>()) {
+            type = type->op(i);
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+class LICM {
+public:
+    LICM(const Scope& scope, const Schedule& schedule, const DefMap<Continuation*>& blocks, const InductionLoop& loop)
+        : scope_(scope)
+        , schedule_(schedule)
+        , blocks_(blocks)
+        , loop_(loop)
+    {
+        collect();
+    }
+
+    World& world() const { return scope_.world(); }
+    bool hoist_loads();
+    bool sink_store();
+
+private:
+    void collect();
+    /// Is @p continuation executed in each iteration and at least once before the loop is left?
+    bool is_guaranteed(Continuation* continuation) const;
+    /// Does a @p Store of the loop other than @p except - or a @p Load if @p loads is set - access the location @p ptr?
+    bool may_access(const Def* ptr, const Store* except, bool loads) const;
+    bool is_in_loop(const PrimOp* primop) const { return loop_.contains(blocks_.find(primop)->second); }
+
+    const Scope& scope_;
+    const Schedule& schedule_;
+    const DefMap<Continuation*>& blocks_;
+    const InductionLoop& loop_;
+    std::vector<const Load*> loads_;
+    std::vector<const Store*> stores_;
+    bool clobbers_ = false; ///< Does the loop call a function or run a @p MemOp which may access any memory?
+    bool head_has_memops_ = false;
+};
+
+void LICM::collect() {
+    for (auto& block : schedule_) {
+        auto continuation = block.continuation();
+        if (!loop_.contains(continuation))
+            continue;
+
+        for (auto primop : block) {
+            if (auto load = primop->isa<Load>())
+                loads_.push_back(load);
+            else if (auto store = primop->isa<Store>())
+                stores_.push_back(store);
+            else if (primop->isa<MemOp>() && !primop->isa<Enter>() && !primop->isa<Alloc>())
+                clobbers_ = true;
+
+            if (primop->isa<MemOp>() && continuation == loop_.head())
+                head_has_memops_ = true;
+        }
+
+        if (!continuation->callee()->type()->as<FnType>()->is_basicblock()) {
+            for (auto arg : continuation->args()) {
+                if (is_mem(arg))
+                    clobbers_ = true;
+            }
+        }
+    }
+}
+
+bool LICM::is_guaranteed(Continuation* continuation) const {
+    if (continuation == loop_.head())
+        return true;
+    if (!loop_.is_single_exit() || !loop_.has_constant_trip_count() || loop_.trip_count() == 0)
+        return false;
+
+    const auto& cfg = scope_.f_cfg();
+    auto n = cfg[continuation];
+    return cfg.domtree().lca(n, cfg[loop_.latch()]) == n;
+}
+
+bool LICM::may_access(const Def* ptr, const Store* except, bool loads) const {
+    for (auto store : stores_) {
+        if (store != except && alias(store->ptr(), ptr) != AliasResult::No)
+            return true;
+    }
+    if (loads) {
+        for (auto load : loads_) {
+            if (alias(load->ptr(), ptr) != AliasResult::No)
+                return true;
+        }
+    }
+    return false;
+}
+
+static size_t mem_arg_index(Continuation* continuation) {
+    for (size_t i = 0, e = continuation->num_args(); i != e; ++i) {
+        if (is_mem(continuation->arg(i)))
+            return i;
+    }
+    return size_t(-1);
+}
+
+bool LICM::hoist_loads() {
+    auto entry = loop_.entry();
+    auto index = mem_arg_index(entry);
+    if (clobbers_ || index == size_t(-1))
+        return false;
+
+    auto mem = entry->arg(index);
+    bool todo = false;
+    for (auto load : loads_) {
+        auto ptr = load->ptr();
+        if (!loop_.is_invariant(ptr) || may_access(ptr, nullptr, false))
+            continue;
+        if (!is_guaranteed(blocks_.find(load)->second) && !is_dereferenceable(ptr))
+            continue;
+
+        DLOG("hoisting {} out of loop {}", load, loop_.head());
+        auto hoisted = world().load(mem, ptr, load->debug(), load->flags());
+        mem = world().extract(hoisted, 0_u32, load->debug());
+        load->out_val()->replace(world().extract(hoisted, 1_u32, load->debug()));
+        load->out_mem()->replace(load->mem());
+        todo = true;
+    }
+
+    if (todo)
+        entry->update_arg(index, mem);
+    return todo;
+}
+
+bool LICM::sink_store() {
+    auto head = loop_.head();
+    auto entry = loop_.entry();
+    auto latch = loop_.latch();
+    auto head_mem = head->mem_param();
+    auto index = mem_arg_index(entry);
+    if (clobbers_ || head_has_memops_ || !loop_.is_single_exit() || head_mem == nullptr || index == size_t(-1))
+        return false;
+
+    // we are going to add a param to the head
+    for (auto use : head->uses()) {
+        if (use.index() != 0 || (use.def() != entry && use.def() != latch))
+            return false;
+    }
+
+    // the mem leaving the loop must only flow into jumps and MemOps we can rewire
+    std::vector<Use> exits;
+    for (auto use : head_mem->uses()) {
+        if (auto continuation = use->isa_continuation()) {
+            if (!loop_.contains(continuation))
+                exits.push_back(use);
+        } else if (auto memop = use->isa<MemOp>()) {
+            if (!is_in_loop(memop))
+                exits.push_back(use);
+        } else {
+            return false;
+        }
+    }
+
+    for (auto store : stores_) {
+        auto ptr = store->ptr();
+        auto block = blocks_.find(store)->second;
+        if (block == head || !loop_.is_invariant(ptr) || may_access(ptr, store, true))
+            continue;
+
+        const auto& cfg = scope_.f_cfg();
+        if (cfg.domtree().lca(cfg[block], cfg[latch]) != cfg[block])
+            continue;
+
+        // if the loop might not run at all, start with what is in memory and write it back
+        const Def* init;
+        if (is_guaranteed(block))
+            init = world().bottom(store->val()->type());
+        else if (is_dereferenceable(ptr) && !is_escaping(MemLoc(ptr).object())) {
+            auto load = world().load(entry->arg(index), ptr, store->debug());
+            entry->update_arg(index, world().extract(load, 0_u32, store->debug()));
+            init = world().extract(load, 1_u32, store->debug());
+        } else
+            continue;
+
+        DLOG("sinking {} out of loop {}", store, head);
+        auto val = head->append_param(store->val()->type(), store->debug());
+        Array<const Def*> entry_args(entry->num_args() + 1);
+        *std::copy(entry->args().begin(), entry->args().end(), entry_args.begin()) = init;
+        entry->jump(head, entry_args, entry->jump_debug());
+        Array<const Def*> latch_args(latch->num_args() + 1);
+        *std::copy(latch->args().begin(), latch->args().end(), latch_args.begin()) = store->val();
+        latch->jump(head, latch_args, latch->jump_debug());
+
+        auto sunk = world().store(head_mem, ptr, val, store->debug(), store->flags());
+        for (auto use : exits) {
+            if (auto continuation = use->isa_continuation()) {
+                continuation->update_op(use.index(), sunk);
+            } else {
+                auto memop = use->as<MemOp>();
+                Array<const Def*> ops(memop->ops());
+                ops[use.index()] = sunk;
+                memop->replace(memop->rebuild(ops));
+            }
+        }
+        store->replace(store->mem());
+        return true;
+    }
+
+    return false;
+}
+
+void licm(World& world) {
+    VLOG("start licm");
+
+    size_t num_loops = 0;
+    Scope::for_each(world, [&] (Scope& scope) {
+        for (bool todo = true; todo;) {
+            todo = false;
+
+            Induction induction(scope.f_cfg().looptree());
+            if (induction.loops().empty())
+                break;
+
+            Schedule schedule(scope);
+            DefMap<Continuation*> blocks;
+            for (auto& block : schedule) {
+                for (auto primop : block)
+                    blocks[primop] = block.continuation();
+            }
+
+            for (const auto& loop : induction.loops()) {
+                LICM licm(scope, schedule, blocks, *loop);
+                if (licm.hoist_loads() || licm.sink_store()) {
+                    ++num_loops;
+                    // the scope is stale now
+                    todo = true;
+                    break;
+                }
+            }
+
+            if (todo)
+                scope.update();
+        }
+    });
+
+    VLOG("stop licm: moved memory operations out of loops {} times", num_loops);
+    debug_verify(world);
+    world.cleanup();
+}
+
+}
@@ -0,0 +1,20 @@
+#ifndef THORIN_TRANSFORM_LICM_H
+#define THORIN_TRANSFORM_LICM_H
+
+namespace thorin {
+
+class World;
+
+/**
+ * Loop-invariant code motion for memory operations.
+ * Pure @p PrimOp%s already leave loops via the @p Schedule; @p Load%s and @p Store%s are pinned by the mem chain, though.
+ * This moves a @p Load from an invariant address which nothing in its @p InductionLoop may write to into the entry of the loop.
+ * A @p Store to an invariant address which nothing else in the loop may access is sunk to the loop exit instead:
+ * The value of the last iteration is carried by a new parameter of the loop header.
+ * Accesses are only moved if they are executed in each iteration or their address is known to be dereferenceable.
+ */
+void licm(World&);
+
+}
+
+#endif
@@ -0,0 +1,299 @@
+#include "thorin/transform/loop_fusion.h"
+
+#include <algorithm>
+
+#include "thorin/continuation.h"
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/alias.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/induction.h"
+#include "thorin/analyses/looptree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/analyses/verify.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+/// The @p Load%s and @p Store%s of an @p InductionLoop.
+struct Accesses {
+    std::vector<const Access*> accesses;
+    bool is_analyzable = true; ///< Is there no call or other @p MemOp which may access any memory?
+};
+
+static Accesses collect(const Schedule& schedule, const InductionLoop& loop) {
+    Accesses result;
+    for (auto& block : schedule) {
+        auto continuation = block.continuation();
+        if (!loop.contains(continuation))
+            continue;
+
+        for (auto primop : block) {
+            if (auto access = primop->isa<Access>())
+                result.accesses.push_back(access);
+            else if (primop->isa<MemOp>() && !primop->isa<Enter>() && !primop->isa<Alloc>())
+                result.is_analyzable = false;
+
+            // the head is going to be dropped or its mem is going to be split
+            if (primop->isa<MemOp>() && continuation == loop.head())
+                result.is_analyzable = false;
+        }
+
+        if (!continuation->callee()->type()->as<FnType>()->is_basicblock()) {
+            for (auto arg : continuation->args()) {
+                if (is_mem(arg))
+                    result.is_analyzable = false;
+            }
+        }
+    }
+    return result;
+}
+
+/// Do @p ptr1 and @p ptr2 only coincide within the same iteration as they are indexed by @p var1 and @p var2 in lockstep?
+static bool is_same_iteration(const Def* ptr1, const Def* ptr2, const Param* var1, const Param* var2) {
+    MemLoc loc1(ptr1), loc2(ptr2);
+    if (loc1.base() != loc2.base() || loc1.path().size() != loc2.path().size())
+        return false;
+
+    bool indexed = false;
+    for (size_t i = 0, e = loc1.path().size(); i != e; ++i) {
+        auto index1 = loc1.path()[i], index2 = loc2.path()[i];
+        if (index1 == var1 && index2 == var2)
+            indexed = true;
+        else if (index1 != index2 || index1 == var1 || index2 == var2)
+            return false;
+    }
+    return indexed;
+}
+
+/// Does anything reachable from the jumps of the continuations of @p loop use a @p Param of @p other?
+static bool uses_params_of(const InductionLoop& loop, const InductionLoop& other) {
+    std::vector<const Def*> stack;
+    DefSet done;
+    for (auto continuation : loop.body()) {
+        for (auto op : continuation->ops()) {
+            if (done.emplace(op).second)
+                stack.push_back(op);
+        }
+    }
+
+    while (!stack.empty()) {
+        auto def = stack.back();
+        stack.pop_back();
+
+        if (auto param = def->isa<Param>()) {
+            if (other.contains(param->continuation()))
+                return true;
+        } else if (auto primop = def->isa<PrimOp>()) {
+            for (auto op : primop->ops()) {
+                if (done.emplace(op).second)
+                    stack.push_back(op);
+            }
+        }
+    }
+
+    return false;
+}
+
+class LoopFusion {
+public:
+    LoopFusion(const Scope& scope, const Schedule& schedule, const InductionLoop& first, const InductionLoop& second)
+        : scope_(scope)
+        , schedule_(schedule)
+        , first_(first)
+        , second_(second)
+    {}
+
+    World& world() const { return scope_.world(); }
+    bool is_legal() const;
+    void fuse();
+
+private:
+    Continuation* exit(const InductionLoop& loop) const { return loop.head()->arg(3 - loop.stay())->as_continuation(); }
+    Continuation* stay(const InductionLoop& loop) const { return loop.head()->arg(loop.stay())->as_continuation(); }
+    bool is_in_second(const Def* def) const;
+
+    const Scope& scope_;
+    const Schedule& schedule_;
+    const InductionLoop& first_;
+    const InductionLoop& second_;
+};
+
+bool LoopFusion::is_in_second(const Def* def) const {
+    if (auto continuation = def->isa_continuation())
+        return second_.contains(continuation);
+    for (auto& block : schedule_) {
+        if (std::find(block.begin(), block.end(), def) != block.end())
+            return second_.contains(block.continuation());
+    }
+    THORIN_UNREACHABLE;
+}
+
+bool LoopFusion::is_legal() const {
+    auto var1 = first_.exit_var(), var2 = second_.exit_var();
+    if (var1 == nullptr || var2 == nullptr || !first_.is_single_exit() || !second_.is_single_exit())
+        return false;
+    if (first_.node()->parent() != second_.node()->parent())
+        return false;
+
+    // same iteration space
+    if (var1->start != var2->start || var1->step != var2->step
+            || first_.cmp_tag() != second_.cmp_tag() || first_.bound() != second_.bound())
+        return false;
+
+    // the exit of the first loop must directly enter the second one and nothing may observe the params of the second head
+    auto entry = second_.entry();
+    auto head1 = first_.head(), head2 = second_.head();
+    if (exit(first_) != entry || entry->num_uses() != 1)
+        return false;
+    for (auto use : head2->uses()) {
+        if (use.index() != 0 || (use.def() != entry && use.def() != second_.latch()))
+            return false;
+    }
+    for (auto use : head1->uses()) {
+        if (use.index() != 0 || (use.def() != first_.entry() && use.def() != first_.latch()))
+            return false;
+    }
+
+    // the second loop must not depend on the results of the first one
+    for (size_t i = 0, e = entry->num_args(); i != e; ++i) {
+        auto arg = entry->arg(i);
+        if (is_mem(arg)) {
+            if (arg != head1->mem_param())
+                return false;
+        } else if (head2->param(i) != var2->param && !first_.is_invariant(arg)) {
+            return false;
+        }
+    }
+    if (head2->mem_param() != nullptr && head1->mem_param() == nullptr)
+        return false;
+    if (uses_params_of(second_, first_))
+        return false;
+
+    // the mem of the second head must only flow into jumps and MemOps we can rewire
+    if (auto mem = head2->mem_param()) {
+        for (auto use : mem->uses()) {
+            if (!use->isa_continuation() && !use->isa<MemOp>())
+                return false;
+        }
+    }
+
+    // no fusion-preventing dependences
+    auto accesses1 = collect(schedule_, first_);
+    auto accesses2 = collect(schedule_, second_);
+    if (!accesses1.is_analyzable || !accesses2.is_analyzable)
+        return false;
+
+    for (auto a : accesses1.accesses) {
+        for (auto b : accesses2.accesses) {
+            if (a->isa<Load>() && b->isa<Load>())
+                continue;
+            if (alias(a->ptr(), b->ptr()) == AliasResult::No)
+                continue;
+            if (!is_same_iteration(a->ptr(), b->ptr(), var1->param, var2->param))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void LoopFusion::fuse() {
+    auto head1 = first_.head(), head2 = second_.head();
+    auto entry1 = first_.entry(), latch1 = first_.latch();
+    auto entry2 = second_.entry(), latch2 = second_.latch();
+    auto body2 = stay(second_), exit2 = exit(second_);
+    DLOG("fusing loops {} and {}", head1, head2);
+
+    // the head of the first loop takes over the params of the second one
+    Array<const Def*> entry_args(entry1->args());
+    Array<const Def*> latch_args(latch1->args());
+    std::vector<size_t> indices;
+    std::vector<const Def*> init, next;
+    for (auto param : head2->params()) {
+        if (param == head2->mem_param() || param == second_.exit_var()->param)
+            continue;
+        indices.push_back(param->index());
+        init.push_back(entry2->arg(param->index()));
+        param->replace(head1->append_param(param->type(), param->debug()));
+    }
+    second_.exit_var()->param->replace(first_.exit_var()->param);
+
+    // within the fused loop, the second body continues the mem chain of the first one; its exit continues the one of the head
+    if (auto mem2 = head2->mem_param()) {
+        auto mem1 = head1->mem_param();
+        auto body_mem = latch1->arg(mem1->index());
+        for (auto use : mem2->copy_uses()) {
+            auto mem = is_in_second(use.def()) ? body_mem : mem1;
+            if (auto continuation = use->isa_continuation()) {
+                continuation->update_op(use.index(), mem);
+            } else {
+                auto memop = use->as<MemOp>();
+                Array<const Def*> ops(memop->ops());
+                ops[use.index()] = mem;
+                memop->replace(memop->rebuild(ops));
+            }
+        }
+        latch_args[mem1->index()] = latch2->arg(mem2->index());
+    }
+
+    for (auto index : indices)
+        next.push_back(latch2->arg(index));
+
+    Array<const Def*> new_entry_args(entry_args.size() + init.size());
+    std::copy(init.begin(), init.end(), std::copy(entry_args.begin(), entry_args.end(), new_entry_args.begin()));
+    Array<const Def*> new_latch_args(latch_args.size() + next.size());
+    std::copy(next.begin(), next.end(), std::copy(latch_args.begin(), latch_args.end(), new_latch_args.begin()));
+
+    entry1->jump(head1, new_entry_args, entry1->jump_debug());
+    latch1->jump(body2, {}, latch1->jump_debug());
+    latch2->jump(head1, new_latch_args, latch2->jump_debug());
+    head1->update_arg(3 - first_.stay(), exit2);
+
+    // both are dead now but the params of the second head must not be touched anymore
+    entry2->destroy_body();
+    head2->destroy_body();
+}
+
+void loop_fusion(World& world) {
+    VLOG("start loop fusion");
+
+    size_t num = 0;
+    Scope::for_each(world, [&] (Scope& scope) {
+        for (bool todo = true; todo;) {
+            todo = false;
+
+            Induction induction(scope.f_cfg().looptree());
+            if (induction.loops().size() < 2)
+                break;
+
+            Schedule schedule(scope);
+            for (const auto& first : induction.loops()) {
+                auto exit = first->head()->arg(3 - first->stay())->as_continuation();
+                auto head = exit->callee()->isa_continuation();
+                auto second = head != nullptr ? induction[head] : nullptr;
+                if (second == nullptr || second == first.get() || second->entry() != exit)
+                    continue;
+
+                LoopFusion fusion(scope, schedule, *first, *second);
+                if (fusion.is_legal()) {
+                    fusion.fuse();
+                    ++num;
+                    // the scope is stale now
+                    todo = true;
+                    break;
+                }
+            }
+
+            if (todo)
+                scope.update();
+        }
+    });
+
+    VLOG("stop loop fusion: {} loops fused", num);
+    debug_verify(world);
+    world.cleanup();
+}
+
+}
@@ -0,0 +1,19 @@
+#ifndef THORIN_TRANSFORM_LOOP_FUSION_H
+#define THORIN_TRANSFORM_LOOP_FUSION_H
+
+namespace thorin {
+
+class World;
+
+/**
+ * Fuses an @p InductionLoop with the one its exit directly enters if both run over the same iteration space.
+ * Both exit tests must compare an induction variable with the same start and step to the same bound.
+ * Loops are not fused if the second one depends on values of the first one or if an access of one loop may touch
+ * memory the other one writes in a different iteration.
+ * The fused loop streams each element through both bodies at once instead of traversing the memory twice.
+ */
+void loop_fusion(World&);
+
+}
+
+#endif
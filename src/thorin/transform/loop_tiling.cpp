@@ -0,0 +1,352 @@
+#include "thorin/transform/loop_tiling.h"
+
+#include <algorithm>
+
+#include "thorin/continuation.h"
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/alias.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/induction.h"
+#include "thorin/analyses/looptree.h"
+#include "thorin/analyses/schedule.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/analyses/verify.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+/// The unsigned integer type with as many bits as the integer @p type.
+static const Type* unsigned_type(World& world, const Type* type) {
+    auto tag = type->as<PrimType>()->primtype_tag();
+    if (is_type_ps(tag))
+        tag = PrimTypeTag(tag - Begin_PrimType_ps + Begin_PrimType_pu);
+    else if (is_type_qs(tag))
+        tag = PrimTypeTag(tag - Begin_PrimType_qs + Begin_PrimType_qu);
+    return world.type(tag);
+}
+
+class LoopTiling {
+public:
+    LoopTiling(const Scope& scope, const Schedule& schedule, const InductionLoop& outer, const InductionLoop& inner)
+        : scope_(scope)
+        , schedule_(schedule)
+        , outer_(outer)
+        , inner_(inner)
+    {}
+
+    World& world() const { return scope_.world(); }
+    bool is_perfect_nest() const;
+    bool has_reversible_dependences() const;
+    /// Do the steps of both tile loops - the step of each loop times its tile size - fit into the types of their induction variables?
+    bool has_valid_steps(u64 outer_size, u64 inner_size) const { return fits(outer_, outer_size) && fits(inner_, inner_size); }
+    void tile(u64 outer_size, u64 inner_size);
+
+private:
+    bool is_simple(const InductionLoop& loop) const;
+    static bool fits(const InductionLoop& loop, u64 size);
+    Continuation* exit(const InductionLoop& loop) const { return loop.head()->arg(3 - loop.stay())->as_continuation(); }
+    Continuation* stay(const InductionLoop& loop) const { return loop.head()->arg(loop.stay())->as_continuation(); }
+
+    const Scope& scope_;
+    const Schedule& schedule_;
+    const InductionLoop& outer_;
+    const InductionLoop& inner_;
+};
+
+/// Does @p loop count upwards with @c lt, carry nothing but its mem and its induction variable and is only jumped to from its entry and latch?
+bool LoopTiling::is_simple(const InductionLoop& loop) const {
+    auto head = loop.head();
+    auto var = loop.exit_var();
+    if (var == nullptr || loop.cmp_tag() != Cmp_lt || var->step <= 0 || !loop.is_single_exit())
+        return false;
+    if (head->num_params() != 2 || head->mem_param() == nullptr)
+        return false;
+    for (auto use : head->uses()) {
+        if (use.index() != 0 || (use.def() != loop.entry() && use.def() != loop.latch()))
+            return false;
+    }
+    return true;
+}
+
+bool LoopTiling::fits(const InductionLoop& loop, u64 size) {
+    auto tag = loop.exit_var()->param->type()->as<PrimType>()->primtype_tag();
+    // the step is built as an s64 literal
+    auto bits = std::min(num_bits(tag) - (is_type_s(tag) ? 1 : 0), 63);
+    auto max = (u64(1) << bits) - 1;
+    auto step = u64(loop.exit_var()->step);
+    return size != 0 && size <= max / step;
+}
+
+bool LoopTiling::is_perfect_nest() const {
+    if (!is_simple(outer_) || !is_simple(inner_) || inner_.node()->parent() != outer_.node())
+        return false;
+
+    // the outer body must consist of nothing but the inner loop and the jumps into and out of it
+    auto entry = inner_.entry(), latch = outer_.latch();
+    if (stay(outer_) != entry || exit(inner_) != latch || outer_.body().size() != inner_.body().size() + 3)
+        return false;
+    if (entry->num_uses() != 1 || latch->num_uses() != 1)
+        return false;
+    if (entry->arg(inner_.head()->mem_param()->index()) != outer_.head()->mem_param()
+            || latch->arg(outer_.head()->mem_param()->index()) != inner_.head()->mem_param())
+        return false;
+    for (auto& block : schedule_) {
+        auto continuation = block.continuation();
+        if (continuation != outer_.head() && continuation != entry && continuation != latch && continuation != inner_.head())
+            continue;
+        for (auto primop : block) {
+            if (primop->isa<MemOp>())
+                return false;
+        }
+    }
+
+    // rectangular iteration space
+    if (!outer_.is_invariant(inner_.exit_var()->start) || !outer_.is_invariant(inner_.bound()))
+        return false;
+
+    // nothing but the mem of the outer head may leave the nest
+    std::vector<const Def*> stack;
+    DefSet done;
+    for (auto n : scope_.f_cfg().reverse_post_order()) {
+        if (outer_.contains(n->continuation()))
+            continue;
+        for (auto op : n->continuation()->ops()) {
+            if (done.emplace(op).second)
+                stack.push_back(op);
+        }
+    }
+    while (!stack.empty()) {
+        auto def = stack.back();
+        stack.pop_back();
+
+        if (auto param = def->isa<Param>()) {
+            if (outer_.contains(param->continuation()) && param != outer_.head()->mem_param())
+                return false;
+        } else if (auto primop = def->isa<PrimOp>()) {
+            for (auto op : primop->ops()) {
+                if (done.emplace(op).second)
+                    stack.push_back(op);
+            }
+        }
+    }
+
+    for (auto use : outer_.head()->mem_param()->uses()) {
+        if (!use->isa_continuation() && !use->isa<MemOp>())
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Tiling preserves the order of all iterations with the same index of either loop.
+ * Thus, each location written in the nest must only be accessed via the very same pointer
+ * which is indexed by one of the induction variables directly.
+ */
+bool LoopTiling::has_reversible_dependences() const {
+    std::vector<const Access*> accesses;
+    for (auto& block : schedule_) {
+        auto continuation = block.continuation();
+        if (!outer_.contains(continuation))
+            continue;
+
+        for (auto primop : block) {
+            if (auto access = primop->isa<Access>())
+                accesses.push_back(access);
+            else if (primop->isa<MemOp>() && !primop->isa<Enter>() && !primop->isa<Alloc>())
+                return false;
+        }
+
+        if (!continuation->callee()->type()->as<FnType>()->is_basicblock()) {
+            for (auto arg : continuation->args()) {
+                if (is_mem(arg))
+                    return false;
+            }
+        }
+    }
+
+    auto is_indexed = [&] (const Def* ptr) {
+        MemLoc loc(ptr);
+        for (auto var : { outer_.exit_var()->param, inner_.exit_var()->param }) {
+            if (std::find(loc.path().begin(), loc.path().end(), var) != loc.path().end())
+                return true;
+        }
+        return false;
+    };
+
+    for (auto a : accesses) {
+        for (auto b : accesses) {
+            if ((a->isa<Load>() && b->isa<Load>()) || alias(a->ptr(), b->ptr()) == AliasResult::No)
+                continue;
+            if (a->ptr() != b->ptr() || !is_indexed(a->ptr()))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void LoopTiling::tile(u64 outer_size, u64 inner_size) {
+    auto& w = world();
+    auto head_o = outer_.head(), head_i = inner_.head();
+    auto var_o = outer_.exit_var()->param, var_i = inner_.exit_var()->param;
+    auto mem_o = head_o->mem_param();
+    auto exit_o = exit(outer_), entry_i = inner_.entry(), body_i = stay(inner_), latch_o = outer_.latch();
+    DLOG("tiling {} and {} by {}x{}", head_o, head_i, outer_size, inner_size);
+
+    // the mem leaving the nest must be rewired to the outer tile loop
+    DefSet inside;
+    for (auto& block : schedule_) {
+        if (outer_.contains(block.continuation())) {
+            for (auto primop : block)
+                inside.insert(primop);
+        }
+    }
+    std::vector<Use> exits;
+    for (auto use : mem_o->uses()) {
+        if (auto continuation = use->isa_continuation()) {
+            if (!outer_.contains(continuation))
+                exits.push_back(use);
+        } else if (!inside.contains(use.def())) {
+            exits.push_back(use);
+        }
+    }
+
+    auto lit = [&] (const Type* type, s64 val) { return w.cast(type, w.literal_qs64(val, {})); };
+    // x + step but at most bound for x < bound; x + step itself may wrap, the unsigned distance from x to bound may not
+    auto next = [&] (const Def* x, const Def* step, const Def* bound) {
+        auto type = unsigned_type(w, x->type());
+        auto dist = w.bitcast(type, w.arithop_sub(bound, x));
+        return w.select(w.cmp(Cmp_le, dist, w.bitcast(type, step)), bound, w.arithop_add(x, step));
+    };
+    auto args = [&] (Continuation* head, const Def* mem, const Def* var) {
+        Array<const Def*> result(2);
+        result[head->mem_param()->index()] = mem;
+        result[1 - head->mem_param()->index()] = var;
+        return result;
+    };
+
+    // tile loops
+    auto tile_o = w.continuation(head_o->type(), Debug(head_o->name() + "_tile"));
+    auto tile_i = w.continuation(head_i->type(), Debug(head_i->name() + "_tile"));
+    auto tile_o_body = w.basicblock(Debug("tile_body"));
+    auto tile_i_body = w.basicblock(Debug("tile_body"));
+    auto tile_i_exit = w.basicblock(Debug("tile_exit"));
+    auto point_o_exit = w.basicblock(Debug("point_exit"));
+    auto ii = tile_o->param(var_o->index()), jj = tile_i->param(var_i->index());
+    auto step_o = lit(var_o->type(), outer_.exit_var()->step * s64(outer_size));
+    auto step_i = lit(var_i->type(), inner_.exit_var()->step * s64(inner_size));
+
+    outer_.entry()->update_callee(tile_o);
+    tile_o->branch(w.cmp(Cmp_lt, ii, outer_.bound()), tile_o_body, exit_o);
+    tile_o_body->jump(tile_i, args(tile_i, tile_o->mem_param(), inner_.exit_var()->start));
+    tile_i->branch(w.cmp(Cmp_lt, jj, inner_.bound()), tile_i_body, tile_i_exit);
+    tile_i_body->jump(head_o, args(head_o, tile_i->mem_param(), ii));
+    tile_i_exit->jump(tile_o, args(tile_o, tile_i->mem_param(), next(ii, step_o, outer_.bound())));
+
+    // point loops
+    head_o->branch(w.cmp(Cmp_lt, var_o, next(ii, step_o, outer_.bound())), entry_i, point_o_exit, head_o->jump_debug());
+    point_o_exit->jump(tile_i, args(tile_i, mem_o, next(jj, step_i, inner_.bound())));
+    entry_i->update_arg(var_i->index(), jj);
+    head_i->branch(w.cmp(Cmp_lt, var_i, next(jj, step_i, inner_.bound())), body_i, latch_o, head_i->jump_debug());
+
+    for (auto use : exits) {
+        if (auto continuation = use->isa_continuation()) {
+            continuation->update_op(use.index(), tile_o->mem_param());
+        } else {
+            auto memop = use->as<MemOp>();
+            Array<const Def*> ops(memop->ops());
+            ops[use.index()] = tile_o->mem_param();
+            memop->replace(memop->rebuild(ops));
+        }
+    }
+}
+
+/// Finds the loop directly nested in @p outer which makes up its body.
+static const InductionLoop* inner_loop(const Induction& induction, const InductionLoop& outer) {
+    auto entry = outer.head()->arg(outer.stay())->as_continuation();
+    if (auto head = entry->callee()->isa_continuation()) {
+        if (auto inner = induction[head]) {
+            if (inner->entry() == entry && inner->node()->parent() == outer.node())
+                return inner;
+        }
+    }
+    return nullptr;
+}
+
+void loop_tiling(World& world, const TileConfig& config) {
+    VLOG("start loop tiling");
+
+    size_t num = 0;
+    ContinuationSet done;
+    Scope::for_each(world, [&] (Scope& scope) {
+        for (bool todo = true; todo;) {
+            todo = false;
+
+            std::vector<Continuation*> markers;
+            for (auto n : scope.f_cfg().reverse_post_order()) {
+                auto callee = n->continuation()->callee()->isa_continuation();
+                if (callee != nullptr && callee->intrinsic() == Intrinsic::Tile)
+                    markers.push_back(n->continuation());
+            }
+            if (markers.empty() && config.annotated_only)
+                break;
+
+            Induction induction(scope.f_cfg().looptree());
+            Schedule schedule(scope);
+
+            auto try_tile = [&] (const InductionLoop& outer, u64 outer_size, u64 inner_size, bool check) {
+                auto inner = inner_loop(induction, outer);
+                if (inner == nullptr || done.contains(outer.head()) || done.contains(inner->head()))
+                    return false;
+                LoopTiling tiling(scope, schedule, outer, *inner);
+                if (!tiling.is_perfect_nest() || !tiling.has_valid_steps(outer_size, inner_size)
+                        || (check && !tiling.has_reversible_dependences()))
+                    return false;
+                done.insert(outer.head());
+                done.insert(inner->head());
+                tiling.tile(outer_size, inner_size);
+                ++num;
+                return true;
+            };
+
+            for (auto marker : markers) {
+                auto next = marker->args().back()->as_continuation();
+                auto size = [&] (size_t i, size_t otherwise) {
+                    auto arg = marker->arg(i);
+                    auto n = arg->isa<PrimLit>() ? primlit_value<u64>(arg) : 0;
+                    return n != 0 ? n : otherwise;
+                };
+
+                auto head = next->callee()->isa_continuation();
+                auto outer = head != nullptr ? induction[head] : nullptr;
+                if (outer == nullptr || outer->entry() != next || !try_tile(*outer, size(1, config.outer), size(2, config.inner), false))
+                    WLOG(marker, "tile: cannot tile the loop nest entered by {}", next);
+
+                marker->jump(next, {marker->arg(0)}, marker->jump_debug());
+                todo = true;
+                break;
+            }
+
+            if (!todo && !config.annotated_only) {
+                for (const auto& loop : induction.loops()) {
+                    if (try_tile(*loop, config.outer, config.inner, true)) {
+                        todo = true;
+                        break;
+                    }
+                }
+            }
+
+            // the scope is stale now
+            if (todo)
+                scope.update();
+        }
+    });
+
+    VLOG("stop loop tiling: {} loop nests tiled", num);
+    debug_verify(world);
+    world.cleanup();
+}
+
+}
@@ -0,0 +1,28 @@
+#ifndef THORIN_TRANSFORM_LOOP_TILING_H
+#define THORIN_TRANSFORM_LOOP_TILING_H
+
+#include <cstddef>
+
+namespace thorin {
+
+class World;
+
+/// Parameters of @p loop_tiling.
+struct TileConfig {
+    size_t outer = 32;          ///< Number of iterations of the outer loop per tile unless the annotation says otherwise.
+    size_t inner = 32;          ///< Number of iterations of the inner loop per tile unless the annotation says otherwise.
+    bool annotated_only = true; ///< Only tile nests annotated with @p Intrinsic::Tile?
+};
+
+/**
+ * Cache blocking for perfectly nested pairs of @p InductionLoop%s over a rectangular iteration space.
+ * Both loops are strip-mined and the two resulting tile loops are moved outside of the two point loops.
+ * A nest is annotated by calling <tt>tile(mem, outer, inner, next)</tt> right before it where @p next enters the nest;
+ * literal tile sizes of @c 0 select the ones of the @p TileConfig.
+ * Annotated nests are tiled as requested; other ones only if no dependence between their iterations gets reversed.
+ */
+void loop_tiling(World& world, const TileConfig& config = TileConfig());
+
+}
+
+#endif
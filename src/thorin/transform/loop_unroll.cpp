@@ -0,0 +1,141 @@
+#include "thorin/transform/loop_unroll.h"
+
+#include "thorin/continuation.h"
+#include "thorin/primop.h"
+#include "thorin/world.h"
+#include "thorin/analyses/cfg.h"
+#include "thorin/analyses/induction.h"
+#include "thorin/analyses/looptree.h"
+#include "thorin/analyses/scope.h"
+#include "thorin/analyses/verify.h"
+#include "thorin/transform/mangle.h"
+#include "thorin/util/log.h"
+
+namespace thorin {
+
+typedef LoopTree<true>::Head LoopHead;
+
+static bool is_innermost(const LoopHead* head) {
+    for (const auto& child : head->children()) {
+        if (child->isa<LoopHead>())
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Number of non-literal @p PrimOp%s and continuations each copy of @p loop duplicates.
+ * This is the @p Scope of its head which also contains everything after the loop that depends on its params.
+ */
+static size_t copy_size(const InductionLoop& loop) {
+    Scope scope(loop.head());
+    size_t size = 0;
+    for (auto def : scope.defs()) {
+        if (def->isa_continuation() || (def->isa<PrimOp>() && !def->isa<PrimLit>()))
+            ++size;
+    }
+    return size;
+}
+
+/**
+ * Peels off one iteration after the other by specializing the head for the literal args it receives.
+ * The exit test of each copy folds and the last one leaves the loop.
+ */
+static void unroll_fully(const InductionLoop& loop) {
+    Scope scope(loop.head());
+    auto pred = loop.entry();
+
+    for (size_t n = 0; pred != nullptr; ++n) {
+        assert_unused(n <= loop.trip_count());
+        Array<const Def*> args(loop.head()->num_params());
+        std::vector<const Def*> rest;
+        for (size_t i = 0, e = args.size(); i != e; ++i) {
+            if (pred->arg(i)->isa<PrimLit>())
+                args[i] = pred->arg(i);
+            else
+                rest.push_back(pred->arg(i));
+        }
+
+        Mangler mangler(scope, args, Defs());
+        pred->jump(mangler.mangle(), rest, pred->jump_debug());
+
+        auto latch = mangler.def2def(loop.latch());
+        pred = latch != nullptr && latch->as_continuation()->callee() == loop.head() ? latch->as_continuation() : nullptr;
+    }
+}
+
+/**
+ * Chains @p factor copies of the loop.
+ * As the trip count is a multiple of @p factor, only the exit test of the original @p head may fire.
+ */
+static void unroll_partially(const InductionLoop& loop, size_t factor) {
+    Scope scope(loop.head());
+    Array<const Def*> keep(loop.head()->num_params());
+    auto latch = loop.latch();
+
+    for (size_t i = 1; i != factor; ++i) {
+        Mangler mangler(scope, keep, Defs());
+        auto copy = mangler.mangle();
+        copy->jump(mangler.def2def(loop.head()->arg(loop.stay())), {}, copy->jump_debug());
+
+        Array<const Def*> args(latch->args());
+        latch->jump(copy, args, latch->jump_debug());
+        latch = mangler.def2def(loop.latch())->as_continuation();
+    }
+
+    Array<const Def*> args(latch->args());
+    latch->jump(loop.head(), args, latch->jump_debug());
+}
+
+void loop_unroll(World& world, const UnrollConfig& config) {
+    VLOG("start loop unrolling");
+
+    size_t num_full = 0, num_partial = 0;
+    ContinuationSet done;
+
+    Scope::for_each(world, [&] (Scope& scope) {
+        for (bool todo = true; todo;) {
+            todo = false;
+
+            Induction induction(scope.f_cfg().looptree());
+            for (const auto& loop : induction.loops()) {
+                if (!is_innermost(loop->node()) || !loop->has_constant_trip_count() || !done.insert(loop->head()).second)
+                    continue;
+
+                auto n = loop->trip_count();
+                auto size = copy_size(*loop);
+                DLOG("loop {}: trip count {}, size {}", loop->head(), n, size);
+
+                if (n <= config.max_trip_count && n * size <= config.full_size) {
+                    DLOG("unroll {} fully", loop->head());
+                    unroll_fully(*loop);
+                    ++num_full;
+                    todo = true;
+                } else if (loop->is_single_exit()) {
+                    for (size_t factor = config.max_factor; factor >= 2; --factor) {
+                        if (n % factor == 0 && n > factor && factor * size <= config.partial_size) {
+                            DLOG("unroll {} by {}", loop->head(), factor);
+                            unroll_partially(*loop, factor);
+                            ++num_partial;
+                            todo = true;
+                            break;
+                        }
+                    }
+                }
+
+                // the scope is stale now
+                if (todo)
+                    break;
+            }
+
+            if (todo)
+                scope.update();
+        }
+    });
+
+    VLOG("stop loop unrolling: {} loops fully and {} partially unrolled", num_full, num_partial);
+    debug_verify(world);
+    world.cleanup();
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef THORIN_TRANSFORM_LOOP_UNROLL_H
+#define THORIN_TRANSFORM_LOOP_UNROLL_H
+
+#include <cstddef>
+
+namespace thorin {
+
+class World;
+
+/// Parameters of @p loop_unroll.
+struct UnrollConfig {
+    size_t max_trip_count = 16;  ///< Loops running more often than this are never unrolled fully.
+    size_t full_size = 256;      ///< Maximum size of a copy of a loop times its trip count for full unrolling.
+    size_t partial_size = 128;   ///< Maximum size of a copy of a loop times the unroll factor for partial unrolling.
+    size_t max_factor = 4;       ///< Maximum factor for partial unrolling.
+};
+
+/**
+ * Unrolls innermost loops with a constant trip count.
+ * Loops whose copy - the body plus everything after the loop depending on it - times trip count fits
+ * @p UnrollConfig::full_size are replaced by straight-line code.
+ * Otherwise, if the trip count is a multiple of an unroll factor, the body is replicated within the loop and
+ * the exit tests of the copies are removed.
+ * This helps backends - like the C/OpenCL/CUDA ones - that do not have an unroller of their own.
+ */
+void loop_unroll(World& world, const UnrollConfig& config = UnrollConfig());
+
+}
+
+#endif
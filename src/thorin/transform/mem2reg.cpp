@@ -1,4 +1,5 @@
 #include "thorin/primop.h"
+#include "thorin/ssa_builder.h"
 #include "thorin/world.h"
 #include "thorin/analyses/cfg.h"
 #include "thorin/analyses/scope.h"
@@ -11,6 +12,7 @@ namespace thorin {
 
 void mem2reg(const Scope& scope) {
     const auto& cfg = scope.f_cfg();
+    SSABuilder ssa;
     DefMap<size_t> slot2handle;
     ContinuationMap<size_t> continuation2num;
     DefSet done;
@@ -20,15 +22,12 @@ void mem2reg(const Scope& scope) {
     auto is_address_taken = [&] (const Slot* slot) { return slot2handle[slot] == size_t(-1); };
 
     // unseal all continuations ...
-    for (auto continuation : scope) {
-        continuation->set_parent(continuation);
-        continuation->unseal();
-        assert(continuation->is_cleared());
-    }
+    for (auto continuation : scope)
+        ssa.unseal(continuation);
 
     // ... except top-level continuations
-    scope.entry()->set_parent(nullptr);
-    scope.entry()->seal();
+    ssa.set_parent(scope.entry(), nullptr);
+    ssa.seal(scope.entry());
 
     // set parent pointers for functions passed to accelerator
     for (auto continuation : scope) {
@@ -38,7 +37,7 @@ void mem2reg(const Scope& scope) {
                     if (auto acontinuation = arg->isa_continuation()) {
                         if (!acontinuation->is_basicblock()) {
                             DLOG("{} calls accelerator with {}", continuation, acontinuation);
-                            acontinuation->set_parent(continuation);
+                            ssa.set_parent(acontinuation, continuation);
                         }
                     }
                 }
@@ -83,7 +82,7 @@ void mem2reg(const Scope& scope) {
                 } else if (auto store = primop->isa<Store>()) {
                     if (auto slot = store->ptr()->isa<Slot>()) {
                         if (!is_address_taken(slot)) {
-                            continuation->set_value(slot2handle[slot], store->val());
+                            ssa.set_value(continuation, slot2handle[slot], store->val());
                             done.insert(store);
                             store->replace(store->mem());
                         }
@@ -96,7 +95,7 @@ void mem2reg(const Scope& scope) {
                             auto out_mem = load->out_mem();
                             done.insert(out_val);
                             done.insert(out_mem);
-                            out_val->replace(continuation->get_value(slot2handle[slot], type, slot->debug()));
+                            out_val->replace(ssa.get_value(continuation, slot2handle[slot], type, slot->debug()));
                             out_mem->replace(load->mem());
                         }
                     }
@@ -108,12 +107,12 @@ next_primop:;
         // seal successors of last continuation if applicable
         for (auto succ : cfg.succs(block.node())) {
             auto lsucc = succ->continuation();
-            if (lsucc->parent() != nullptr) {
+            if (ssa.parent(lsucc) != nullptr) {
                 auto i = continuation2num.find(lsucc);
                 if (i == continuation2num.end())
                     i = continuation2num.emplace(lsucc, cfg.num_preds(succ)).first;
                 if (--i->second == 0)
-                    lsucc->seal();
+                    ssa.seal(lsucc);
             }
         }
     }
@@ -122,7 +121,6 @@ next_primop:;
 void mem2reg(World& world) {
     critical_edge_elimination(world);
     Scope::for_each(world, [] (const Scope& scope) { mem2reg(scope); });
-    clear_value_numbering_table(world);
     world.cleanup();
 }
 
@@ -22,6 +22,11 @@ public:
             queue_.push(continuation);
     }
     void eat_pe_info(Continuation*);
+    /// Has @p continuation never been executed according to the @p Profile?
+    bool is_cold(const Continuation* continuation) const {
+        u64 count;
+        return world_.profile().lookup(continuation, count) && count == 0;
+    }
 
 private:
     World& world_;
@@ -63,7 +68,8 @@ public:
         return old2new_[odef] = odef;
     }
 
-    bool eval(size_t i) {
+    /// Specializations requested by a filter are skipped in @p cold code; the ones required for lower2cff are not.
+    bool eval(size_t i, bool cold) {
         // the only higher order parameter that is allowed is a single 1st-order parameter of a top-level continuation
         // all other parameters need specialization (lower2cff)
         auto order = callee_->param(i)->order();
@@ -72,7 +78,7 @@ public:
             return true;
         }
 
-        return (!callee_->is_external() && callee_->num_uses() == 1) || is_one(instantiate(filter(i)));
+        return (!callee_->is_external() && callee_->num_uses() == 1) || (!cold && is_one(instantiate(filter(i))));
         //return is_one(instantiate(filter(i)));
     }
 
@@ -141,10 +147,11 @@ bool PartialEvaluator::run() {
                 call.callee() = callee;
 
                 CondEval cond_eval(callee, continuation->args(), top_level_);
+                bool cold = is_cold(continuation);
 
                 bool fold = false;
                 for (size_t i = 0, e = call.num_args(); i != e; ++i) {
-                    if (force_fold || cond_eval.eval(i)) {
+                    if (force_fold || cond_eval.eval(i, cold)) {
                         call.arg(i) = continuation->arg(i);
                         fold = true;
                     } else
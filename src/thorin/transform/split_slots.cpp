@@ -14,54 +14,72 @@ struct IndexHash {
     static u32 sentinel() { return 0xFFFFFFFF; }
 };
 
+/// Number of elements of the aggregate @p type or 0 if @p type can't be split.
+static u64 num_elems(const Type* type) {
+    if (auto array = type->isa<DefiniteArrayType>())
+        return array->dim();
+    if (type->isa<TupleType>() || type->isa<StructType>())
+        return type->num_ops();
+    return 0;
+}
+
+static const Type* elem_type(const Type* type, u64 index) {
+    if (auto array = type->isa<DefiniteArrayType>())
+        return array->elem_type();
+    return type->op(index);
+}
+
 static void split(const Slot* slot) {
-    auto array_type = slot->alloced_type()->as<DefiniteArrayType>();
-    auto dim = array_type->dim();
-    auto elem_type = array_type->elem_type();
+    auto type = slot->alloced_type();
+    auto dim = num_elems(type);
 
     HashMap<u32, const Def*, IndexHash> new_slots;
     auto& world = slot->world();
 
     auto elem_slot = [&] (u32 index) {
         if (!new_slots.contains(index))
-            new_slots[index] = world.slot(elem_type, slot->frame(), slot->debug());
+            new_slots[index] = world.slot(elem_type(type, index), slot->frame(), slot->debug());
         return new_slots[index];
     };
 
     for (auto use : slot->copy_uses()) {
         if (auto lea = use->isa<LEA>()) {
-            lea->replace(elem_slot(lea->index()->as<PrimLit>()->value().get_u32()));
+            lea->replace(elem_slot(primlit_value<u32>(lea->index())));
         } else if (auto store = use->isa<Store>()) {
             auto in_mem = store->op(0);
             for (size_t i = 0, e = dim; i != e; ++i) {
                 auto elem = world.extract(store->op(2), i, store->debug());
-                in_mem = world.store(in_mem, elem_slot(i), elem, store->debug());
+                in_mem = world.store(in_mem, elem_slot(i), elem, store->debug(), store->flags());
             }
             store->replace(in_mem);
         } else if (auto load = use->isa<Load>()) {
             auto in_mem = load->op(0);
-            auto array = world.bottom(array_type, load->debug());
+            auto agg = world.bottom(type, load->debug());
             for (size_t i = 0, e = dim; i != e; ++i) {
-                auto tuple = world.load(in_mem, elem_slot(i), load->debug());
+                auto tuple = world.load(in_mem, elem_slot(i), load->debug(), load->flags());
                 auto elem = world.extract(tuple, 1_u32, load->debug());
                 in_mem = world.extract(tuple, 0_u32, load->debug());
-                array = world.insert(array, i, elem, load->debug());
+                agg = world.insert(agg, i, elem, load->debug());
             }
-            load->replace(world.tuple({ in_mem, array }, load->debug()));
+            load->replace(world.tuple({ in_mem, agg }, load->debug()));
         }
     }
 }
 
 static bool can_split(const Slot* slot) {
-    if (!slot->alloced_type()->isa<DefiniteArrayType>())
+    auto dim = num_elems(slot->alloced_type());
+    if (dim == 0)
         return false;
 
-    // only accept LEAs with constant indices and loads and stores
+    // only accept LEAs with constant in-bounds indices and loads and stores to the slot
     for (auto use : slot->uses()) {
         if (auto lea = use->isa<LEA>()) {
-            if (!is_const(lea->index()))
+            if (!lea->index()->isa<PrimLit>() || primlit_value<u64>(lea->index()) >= dim)
+                return false;
+        } else if (auto store = use->isa<Store>()) {
+            if (store->ptr() != slot || store->val() == slot)
                 return false;
-        } else if (!use->isa<Store>() && !use->isa<Load>()) {
+        } else if (!use->isa<Load>()) {
             return false;
         }
     }
@@ -6,7 +6,10 @@ namespace thorin {
 class World;
 
 /**
- * Tries to split @p Slot%s that are accessed through constant @p LEA%s.
+ * Scalar replacement of aggregates:
+ * Tries to split @p Slot%s of @p DefiniteArrayType, @p TupleType or @p StructType that are accessed through constant @p LEA%s.
+ * Loads and stores of the whole aggregate are split into element-wise ones.
+ * The resulting element @p Slot%s are split again until only scalars remain which are then up for @p mem2reg.
  */
 void split_slots(World&);
 
@@ -256,16 +256,7 @@ public:
 
     template<class I>
     bool insert(I begin, I end) {
-        size_t s = size() + std::distance(begin, end);
-        size_t c = round_to_power_of_2(s);
-
-        if (s > c/4_s + c/2_s)
-            c *= 4_s;
-
-        c = std::max(c, size_t(capacity_));
-
-        if (c != capacity_)
-            rehash(c);
+        reserve(size() + std::distance(begin, end));
 
         bool changed = false;
         if (on_heap()) {
@@ -364,6 +355,17 @@ public:
     size_t count(const key_type& key) const { return find(key) == end() ? 0 : 1; }
     bool contains(const key_type& key) const { return count(key) == 1; }
 
+    /// Grows the capacity such that @p s elements fit in without triggering a rehash.
+    void reserve(size_t s) {
+        size_t c = round_to_power_of_2(s);
+
+        if (s > c/4_s + c/2_s)
+            c *= 4_s;
+
+        if (c > capacity_)
+            rehash(c);
+    }
+
     void rehash(size_t new_capacity) {
         using std::swap;
 
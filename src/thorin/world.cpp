@@ -1,5 +1,6 @@
 #include "thorin/world.h"
 
+#include <cmath>
 #include <fstream>
 
 #include "thorin/def.h"
@@ -7,16 +8,25 @@
 #include "thorin/continuation.h"
 #include "thorin/type.h"
 #include "thorin/analyses/scope.h"
+#include "thorin/transform/annotate_arithops.h"
 #include "thorin/transform/cleanup_world.h"
 #include "thorin/transform/clone_bodies.h"
 #include "thorin/transform/closure_conversion.h"
+#include "thorin/transform/color_slots.h"
 #include "thorin/transform/codegen_prepare.h"
 #include "thorin/transform/dead_load_opt.h"
+#include "thorin/transform/dead_store_elim.h"
 #include "thorin/transform/flatten_tuples.h"
+#include "thorin/transform/gvn.h"
 #include "thorin/transform/rewrite_flow_graphs.h"
+#include "thorin/transform/heap2stack.h"
 #include "thorin/transform/hoist_enters.h"
 #include "thorin/transform/inliner.h"
+#include "thorin/transform/licm.h"
 #include "thorin/transform/lift_builtins.h"
+#include "thorin/transform/loop_fusion.h"
+#include "thorin/transform/loop_tiling.h"
+#include "thorin/transform/loop_unroll.h"
 #include "thorin/transform/mem2reg.h"
 #include "thorin/transform/partial_evaluation.h"
 #include "thorin/transform/split_slots.h"
@@ -79,11 +89,39 @@ const Def* World::binop(int tag, const Def* lhs, const Def* rhs, Debug dbg) {
     return cmp((CmpTag) tag, lhs, rhs, dbg);
 }
 
-const Def* World::arithop(ArithOpTag tag, const Def* a, const Def* b, Debug dbg) {
+/// Is @p def a floating point literal - or a vector thereof - which equals @p val including its sign?
+static bool is_fp_primlit(const Def* def, double val) {
+    if (auto lit = def->isa<PrimLit>()) {
+        double d;
+        switch (lit->primtype_tag()) {
+#define THORIN_F_TYPE(T, M) case PrimType_##T: d = double(lit->value().get_##M()); break;
+#include "thorin/tables/primtypetable.h"
+            default: return false;
+        }
+        return d == val && std::signbit(d) == std::signbit(val);
+    }
+
+    if (auto vector = def->isa<Vector>()) {
+        for (auto op : vector->ops()) {
+            if (!is_fp_primlit(op, val))
+                return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+const Def* World::arithop(ArithOpTag tag, const Def* a, const Def* b, Debug dbg, ArithOp::Flags flags) {
     assert(a->type() == b->type());
     assert(a->type()->as<PrimType>()->length() == b->type()->as<PrimType>()->length());
     PrimTypeTag type = a->type()->as<PrimType>()->primtype_tag();
 
+    // only keep the flags which make sense for type - otherwise, CSE would miss equal ops
+    if (is_type_f(type))
+        flags = (flags | fast_math()) & ArithOp::Fast;
+    else
+        flags &= ArithOp::IntFlags;
+
     auto llit = a->isa<PrimLit>();
     auto rlit = b->isa<PrimLit>();
     auto lvec = a->isa<Vector>();
@@ -93,7 +131,7 @@ const Def* World::arithop(ArithOpTag tag, const Def* a, const Def* b, Debug dbg)
         size_t num = lvec->type()->as<PrimType>()->length();
         Array<const Def*> ops(num);
         for (size_t i = 0; i != num; ++i)
-            ops[i] = arithop(tag, lvec->op(i), rvec->op(i), dbg);
+            ops[i] = arithop(tag, lvec->op(i), rvec->op(i), dbg, flags);
         return vector(ops, dbg);
     }
 
@@ -345,26 +383,64 @@ const Def* World::arithop(ArithOpTag tag, const Def* a, const Def* b, Debug dbg)
         }
     }
 
+    if (is_type_f(type)) {
+        // these hold for all values
+        if (tag == ArithOp_add && is_fp_primlit(a, -0.0)) return b;
+        if (tag == ArithOp_sub && is_fp_primlit(b,  0.0)) return a;
+        if (tag == ArithOp_mul && is_fp_primlit(a,  1.0)) return b;
+        if (tag == ArithOp_div && is_fp_primlit(b,  1.0)) return a;
+
+        if (flags & ArithOp::NSZ) {
+            if (tag == ArithOp_add && is_fp_primlit(a,  0.0)) return b;
+            if (tag == ArithOp_sub && is_fp_primlit(b, -0.0)) return a;
+        }
+
+        auto finite = ArithOp::NNaN | ArithOp::NInf;
+        if ((flags & finite) == finite) {
+            if (tag == ArithOp_sub && a == b)
+                return zero(type, dbg, vector_length(a));
+            if (tag == ArithOp_mul && (flags & ArithOp::NSZ) && (is_fp_primlit(a, 0.0) || is_fp_primlit(a, -0.0)))
+                return zero(type, dbg, vector_length(a));
+        }
+
+        // x / c -> x * 1/c
+        if (tag == ArithOp_div && rlit && (flags & ArithOp::ARcp)) {
+            switch (type) {
+#define THORIN_F_TYPE(T, M) \
+                case PrimType_##T: \
+                    return arithop(ArithOp_mul, literal(type, Box(M(1) / rlit->value().get_##M()), dbg), a, dbg, flags);
+#include "thorin/tables/primtypetable.h"
+                default: THORIN_UNREACHABLE;
+            }
+        }
+    }
+
     // normalize: try to reorder same ops to have the literal/vector on the left-most side
-    if (is_associative(tag) && is_type_i(a->type())) {
-        auto a_same = a->isa<ArithOp>() && a->as<ArithOp>()->arithop_tag() == tag ? a->as<ArithOp>() : nullptr;
-        auto b_same = b->isa<ArithOp>() && b->as<ArithOp>()->arithop_tag() == tag ? b->as<ArithOp>() : nullptr;
+    if (is_associative(tag) && (is_type_i(a->type()) || (is_type_f(type) && (flags & ArithOp::Reassoc)))) {
+        // integer ops lose their flags as these may not hold anymore after reassociating
+        auto keep = is_type_f(type) ? flags : ArithOp::NoFlag;
+        auto same = [&] (const Def* def) -> const ArithOp* {
+            auto arithop = def->isa<ArithOp>();
+            return arithop && arithop->arithop_tag() == tag && (is_type_i(type) || arithop->is_reassoc()) ? arithop : nullptr;
+        };
+        auto a_same = same(a);
+        auto b_same = same(b);
         auto a_lhs_lv = a_same && (a_same->lhs()->isa<PrimLit>() || a_same->lhs()->isa<Vector>()) ? a_same->lhs() : nullptr;
         auto b_lhs_lv = b_same && (b_same->lhs()->isa<PrimLit>() || b_same->lhs()->isa<Vector>()) ? b_same->lhs() : nullptr;
 
         if (is_commutative(tag)) {
             if (a_lhs_lv && b_lhs_lv)
-                return arithop(tag, arithop(tag, a_lhs_lv, b_lhs_lv, dbg), arithop(tag, a_same->rhs(), b_same->rhs(), dbg), dbg);
+                return arithop(tag, arithop(tag, a_lhs_lv, b_lhs_lv, dbg, keep), arithop(tag, a_same->rhs(), b_same->rhs(), dbg, keep), dbg, keep);
             if ((llit || lvec) && b_lhs_lv)
-                return arithop(tag, arithop(tag, a, b_lhs_lv, dbg), b_same->rhs(), dbg);
+                return arithop(tag, arithop(tag, a, b_lhs_lv, dbg, keep), b_same->rhs(), dbg, keep);
             if (b_lhs_lv)
-                return arithop(tag, b_lhs_lv, arithop(tag, a, b_same->rhs(), dbg), dbg);
+                return arithop(tag, b_lhs_lv, arithop(tag, a, b_same->rhs(), dbg, keep), dbg, keep);
         }
         if (a_lhs_lv)
-            return arithop(tag, a_lhs_lv, arithop(tag, a_same->rhs(), b, dbg), dbg);
+            return arithop(tag, a_lhs_lv, arithop(tag, a_same->rhs(), b, dbg, keep), dbg, keep);
     }
 
-    return cse(new ArithOp(tag, a, b, dbg));
+    return cse(new ArithOp(tag, a, b, flags, dbg));
 }
 
 const Def* World::arithop_not(const Def* def, Debug dbg) { return arithop_xor(allset(def->type(), dbg, vector_length(def)), def, dbg); }
@@ -716,6 +792,31 @@ const Def* World::select(const Def* cond, const Def* a, const Def* b, Debug dbg)
     return cse(new Select(cond, a, b, dbg));
 }
 
+const Def* World::expect(const Def* value, const Def* expected, Debug dbg) {
+    if (value->isa<PrimLit>() || value->isa<Bottom>())
+        return value;
+
+    // a later hint overrides an earlier one
+    if (auto expect = value->isa<Expect>())
+        value = expect->value();
+
+    return cse(new Expect(value, expected, dbg));
+}
+
+const Def* World::aligned(const Def* ptr, u32 align, Debug dbg) {
+    if (align <= 1 || ptr->isa<Bottom>())
+        return ptr;
+
+    // keep the stronger guarantee
+    if (auto aligned = ptr->isa<Aligned>()) {
+        if (aligned->align() >= align)
+            return aligned;
+        ptr = aligned->ptr();
+    }
+
+    return cse(new Aligned(ptr, align, dbg));
+}
+
 const Def* World::size_of(const Type* type, Debug dbg) {
     if (auto ptype = type->isa<PrimType>())
         return literal(qs32(num_bits(ptype->primtype_tag()) / 8), dbg);
@@ -727,7 +828,7 @@ const Def* World::size_of(const Type* type, Debug dbg) {
  * memory stuff
  */
 
-const Def* World::load(const Def* mem, const Def* ptr, Debug dbg) {
+const Def* World::load(const Def* mem, const Def* ptr, Debug dbg, Access::Flags flags) {
     if (auto store = mem->isa<Store>())
         if (store->ptr() == ptr)
             return tuple({mem, store->val()}, dbg);
@@ -768,10 +869,10 @@ const Def* World::load(const Def* mem, const Def* ptr, Debug dbg) {
             }
         }
     }
-    return cse(new Load(mem, ptr, dbg));
+    return cse(new Load(mem, ptr, flags, dbg));
 }
 
-const Def* World::store(const Def* mem, const Def* ptr, const Def* value, Debug dbg) {
+const Def* World::store(const Def* mem, const Def* ptr, const Def* value, Debug dbg, Access::Flags flags) {
     if (value->isa<Bottom>())
         return mem;
 
@@ -782,12 +883,16 @@ const Def* World::store(const Def* mem, const Def* ptr, const Def* value, Debug
 
     if (auto insert = value->isa<Insert>()) {
         if (use_lea(ptr->type()->as<PtrType>()->pointee())) {
-            auto peeled_store = store(mem, ptr, insert->agg(), dbg);
-            return store(peeled_store, lea(ptr, insert->index(), insert->debug()), insert->value(), dbg);
+            auto peeled_store = store(mem, ptr, insert->agg(), dbg, flags);
+            return store(peeled_store, lea(ptr, insert->index(), insert->debug()), insert->value(), dbg, flags);
         }
     }
 
-    return cse(new Store(mem, ptr, value, dbg));
+    return cse(new Store(mem, ptr, value, flags, dbg));
+}
+
+const Def* World::prefetch(const Def* mem, const Def* ptr, bool write, int locality, Debug dbg) {
+    return cse(new Prefetch(mem, ptr, write, locality, dbg));
 }
 
 const Def* World::enter(const Def* mem, Debug dbg) {
@@ -797,7 +902,12 @@ const Def* World::enter(const Def* mem, Debug dbg) {
 }
 
 const Def* World::alloc(const Type* type, const Def* mem, const Def* extra, Debug dbg) {
-    return cse(new Alloc(type, mem, extra, dbg));
+    return cse(new Alloc(type, mem, extra, nullptr, dbg));
+}
+
+const Def* World::region_alloc(const Type* type, const Def* mem, const Def* extra, const Def* region, Debug dbg) {
+    assert(region->type()->isa<PtrType>());
+    return cse(new Alloc(type, mem, extra, region, dbg));
 }
 
 const Def* World::global(const Def* init, bool is_mutable, Debug dbg) {
@@ -860,7 +970,7 @@ const Def* World::run(const Def* def, Debug dbg) {
  */
 
 Continuation* World::continuation(const FnType* fn, CC cc, Intrinsic intrinsic, Debug dbg) {
-    auto l = new Continuation(fn, cc, intrinsic, true, dbg);
+    auto l = new Continuation(fn, cc, intrinsic, dbg);
     THORIN_CHECK_BREAK(l->gid());
     continuations_.insert(l);
 
@@ -883,9 +993,10 @@ Continuation* World::match(const Type* type, size_t num_patterns) {
 }
 
 Continuation* World::basicblock(Debug dbg) {
-    auto bb = new Continuation(fn_type(), CC::C, Intrinsic::None, false, dbg);
+    auto bb = new Continuation(fn_type(), CC::C, Intrinsic::None, dbg);
     THORIN_CHECK_BREAK(bb->gid());
     continuations_.insert(bb);
+    ssa_builder_.unseal(bb);
     return bb;
 }
 
@@ -952,8 +1063,17 @@ void World::opt() {
     closure_conversion(*this);
     lift_builtins(*this);
     inliner(*this);
+    loop_fusion(*this);
+    loop_tiling(*this);
+    loop_unroll(*this);
+    heap2stack(*this);
     hoist_enters(*this);
+    licm(*this);
     dead_load_opt(*this);
+    gvn(*this);
+    dead_store_elim(*this);
+    color_slots(*this);
+    annotate_arithops(*this);
     cleanup();
     codegen_prepare(*this);
     rewrite_flow_graphs(*this);
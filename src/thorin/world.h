@@ -10,6 +10,8 @@
 #include "thorin/enums.h"
 #include "thorin/continuation.h"
 #include "thorin/primop.h"
+#include "thorin/profile.h"
+#include "thorin/ssa_builder.h"
 #include "thorin/util/hash.h"
 #include "thorin/util/stream.h"
 #include "thorin/config.h"
@@ -79,7 +81,7 @@ public:
     const Def* binop(int tag, const Def* lhs, const Def* rhs, Debug dbg = {});
     const Def* arithop_not(const Def* def, Debug dbg = {});
     const Def* arithop_minus(const Def* def, Debug dbg = {});
-    const Def* arithop(ArithOpTag tag, const Def* lhs, const Def* rhs, Debug dbg = {});
+    const Def* arithop(ArithOpTag tag, const Def* lhs, const Def* rhs, Debug dbg = {}, ArithOp::Flags flags = ArithOp::NoFlag);
 #define THORIN_ARITHOP(OP) \
     const Def* arithop_##OP(const Def* lhs, const Def* rhs, Debug dbg = {}) { \
         return arithop(ArithOp_##OP, lhs, rhs, dbg); \
@@ -136,16 +138,22 @@ public:
     }
 
     const Def* select(const Def* cond, const Def* t, const Def* f, Debug dbg = {});
+    const Def* expect(const Def* value, const Def* expected, Debug dbg = {});
+    const Def* likely  (const Def* cond, Debug dbg = {}) { return expect(cond, literal_bool(true,  dbg), dbg); }
+    const Def* unlikely(const Def* cond, Debug dbg = {}) { return expect(cond, literal_bool(false, dbg), dbg); }
+    const Def* aligned(const Def* ptr, u32 align, Debug dbg = {});
     const Def* size_of(const Type* type, Debug dbg = {});
 
     // memory stuff
 
-    const Def* load(const Def* mem, const Def* ptr, Debug dbg = {});
-    const Def* store(const Def* mem, const Def* ptr, const Def* val, Debug dbg = {});
+    const Def* load(const Def* mem, const Def* ptr, Debug dbg = {}, Access::Flags flags = Access::NoFlag);
+    const Def* store(const Def* mem, const Def* ptr, const Def* val, Debug dbg = {}, Access::Flags flags = Access::NoFlag);
+    const Def* prefetch(const Def* mem, const Def* ptr, bool write = false, int locality = 3, Debug dbg = {});
     const Def* enter(const Def* mem, Debug dbg = {});
     const Def* slot(const Type* type, const Def* frame, Debug dbg = {}) { return cse(new Slot(type, frame, dbg)); }
     const Def* alloc(const Type* type, const Def* mem, const Def* extra, Debug dbg = {});
     const Def* alloc(const Type* type, const Def* mem, Debug dbg = {}) { return alloc(type, mem, literal_qu64(0, dbg), dbg); }
+    const Def* region_alloc(const Type* type, const Def* mem, const Def* extra, const Def* region, Debug dbg = {});
     const Def* global(const Def* init, bool is_mutable = true, Debug dbg = {});
     const Def* global_immutable_string(const std::string& str, Debug dbg = {});
     const Def* lea(const Def* ptr, const Def* index, Debug dbg) { return cse(new LEA(ptr, index, dbg)); }
@@ -181,12 +189,20 @@ public:
     const ContinuationSet& continuations() const { return continuations_; }
     Array<Continuation*> copy_continuations() const;
     const ContinuationSet& externals() const { return externals_; }
+    SSABuilder& ssa_builder() { return ssa_builder_; } ///< Serves the value numbering interface of @p Continuation.
+    const Profile& profile() const { return profile_; }
+    Profile& profile() { return profile_; }            ///< Execution counts from a previous instrumented run.
     bool empty() const { return continuations().size() <= 2; } // TODO rework intrinsic stuff. 2 = branch + end_scope
 
     // other stuff
 
     void mark_pe_done(bool flag = true) { pe_done_ = flag; }
     bool is_pe_done() const { return pe_done_; }
+    /// The fast-math @p ArithOp::Flags each floating point @p ArithOp gets in addition to the ones it is built with.
+    ArithOp::Flags fast_math() const { return fast_math_; }
+    void set_fast_math(ArithOp::Flags flags) { assert((flags & ArithOp::Fast) == flags); fast_math_ = flags; }
+    /// Pre-sizes the tables for @p PrimOp%s and @p Type%s in order to avoid repeated rehashing while bulk-importing.
+    void reserve(size_t num_primops, size_t num_types) { primops_.reserve(num_primops); types_.reserve(num_types); }
     void add_external(Continuation* continuation) { externals_.insert(continuation); }
     void remove_external(Continuation* continuation) { externals_.erase(continuation); }
     bool is_external(const Continuation* continuation) { return externals().contains(const_cast<Continuation*>(continuation)); }
@@ -210,9 +226,12 @@ public:
         swap(w1.continuations_, w2.continuations_);
         swap(w1.externals_,     w2.externals_);
         swap(w1.primops_,       w2.primops_);
+        swap(w1.ssa_builder_,   w2.ssa_builder_);
+        swap(w1.profile_,       w2.profile_);
         swap(w1.branch_,        w2.branch_);
         swap(w1.end_scope_,     w2.end_scope_);
         swap(w1.pe_done_,       w2.pe_done_);
+        swap(w1.fast_math_,     w2.fast_math_);
 
 #if THORIN_ENABLE_CHECKS
         swap(w1.breakpoints_,   w2.breakpoints_);
@@ -230,9 +249,12 @@ private:
     ContinuationSet continuations_;
     ContinuationSet externals_;
     PrimOpSet primops_;
+    SSABuilder ssa_builder_;
+    Profile profile_;
     Continuation* branch_;
     Continuation* end_scope_;
     bool pe_done_ = false;
+    ArithOp::Flags fast_math_ = ArithOp::NoFlag;
 #if THORIN_ENABLE_CHECKS
     Breakpoints breakpoints_;
     bool track_history_ = false;